@@ -0,0 +1,167 @@
+// 连接建立→关闭的开销对比：连接池 vs 原先的shared_ptr + std::function方式
+// 用法：make bench && ./Benchmark/connection_churn [连接数]
+#include "../HTTP_Connection/Connection_Pool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <sys/eventfd.h>
+
+// 统计堆分配次数
+static size_t g_allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// 原实现：每个连接new一个TcpConnection、make_shared一个HTTPConnection，
+// 读回调与epoll回调各捕获一个shared_ptr
+class LegacyConnection : public std::enable_shared_from_this<LegacyConnection>
+{
+public:
+    using ReadCallback = std::function<void(std::string &)>;
+
+    static std::shared_ptr<LegacyConnection> create(int fd, EpollReactor &reactor)
+    {
+        return std::shared_ptr<LegacyConnection>(new LegacyConnection(fd, reactor));
+    }
+
+    void start()
+    {
+        reactor_.add_fd(fd_, EPOLLIN | EPOLLET,
+                        [self = shared_from_this()](uint32_t events) {});
+    }
+
+    void set_read_callback(ReadCallback cb) { read_cb_ = std::move(cb); }
+
+    void handle_close()
+    {
+        reactor_.remove_fd(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    LegacyConnection(int fd, EpollReactor &reactor) : fd_(fd), reactor_(reactor) {}
+
+    int fd_;
+    EpollReactor &reactor_;
+    std::string input_buffer_;
+    std::string output_buffer_;
+    bool writing_ = false;
+    bool keep_alive_ = false;
+    ReadCallback read_cb_;
+};
+
+struct LegacyHTTPConnection
+{
+    LegacyHTTPConnection(LegacyConnection &conn, std::string root_dir)
+        : conn_(conn), root_dir_(std::move(root_dir)) {}
+
+    LegacyConnection &conn_;
+    std::string method_;
+    std::string uri_;
+    std::string version_;
+    std::map<std::string, std::string> headers_;
+    bool keep_alive_ = false;
+    const std::string root_dir_;
+};
+
+static int open_fd()
+{
+    int fd = eventfd(0, EFD_NONBLOCK);
+    if (fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    return fd;
+}
+
+struct Result
+{
+    double ns_per_conn;
+    double allocs_per_conn;
+};
+
+// batch个连接为一组：先全部建立再全部关闭
+static Result run_legacy(EpollReactor &reactor, size_t total, size_t batch)
+{
+    std::vector<std::shared_ptr<LegacyConnection>> live;
+    live.reserve(batch);
+
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += batch)
+    {
+        for (size_t i = 0; i < batch; ++i)
+        {
+            auto conn = LegacyConnection::create(open_fd(), reactor);
+            auto http_conn = std::make_shared<LegacyHTTPConnection>(*conn, "./root");
+            conn->set_read_callback([http_conn](std::string &buf) {});
+            conn->start();
+            live.push_back(conn);
+        }
+        for (auto &conn : live)
+        {
+            conn->handle_close();
+        }
+        live.clear();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / total,
+            static_cast<double>(g_allocations - allocations) / total};
+}
+
+static Result run_pool(ConnectionPool &pool, size_t total, size_t batch)
+{
+    std::vector<ConnectionHandle> live;
+    live.reserve(batch);
+
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += batch)
+    {
+        for (size_t i = 0; i < batch; ++i)
+        {
+            live.push_back(pool.open(open_fd()));
+        }
+        for (ConnectionHandle handle : live)
+        {
+            pool.get(handle)->handle_close();
+        }
+        live.clear();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / total,
+            static_cast<double>(g_allocations - allocations) / total};
+}
+
+int main(int argc, char *argv[])
+{
+    size_t total = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    EpollReactor reactor;
+    ConnectionPool pool(reactor, "./root");
+
+    printf("%-8s %-10s %12s %14s\n", "batch", "path", "ns/conn", "allocs/conn");
+    for (size_t batch : {1, 64, 1024})
+    {
+        size_t rounds = total / batch * batch;
+        run_pool(pool, batch, batch); // 预热：池中槽位已分配
+        Result legacy = run_legacy(reactor, rounds, batch);
+        Result pooled = run_pool(pool, rounds, batch);
+        printf("%-8zu %-10s %12.1f %14.2f\n", batch, "shared_ptr", legacy.ns_per_conn, legacy.allocs_per_conn);
+        printf("%-8zu %-10s %12.1f %14.2f\n", batch, "pool", pooled.ns_per_conn, pooled.allocs_per_conn);
+    }
+    return 0;
+}
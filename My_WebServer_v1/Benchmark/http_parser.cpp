@@ -0,0 +1,201 @@
+// 请求解析开销对比：HTTPRequestParser（各分隔符扫描实现）vs 原先的 substr + istringstream + std::map 实现
+// 用法：make bench && ./Benchmark/http_parser [迭代次数]
+#include "../HTTP_Parser/Delimiter_Scan.h"
+#include "../HTTP_Parser/HTTP_Parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+
+// 统计堆分配次数
+static size_t g_allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// 原实现（HTTPConnection::handle_input + parse_request）
+struct LegacyParser
+{
+    std::string method_;
+    std::string uri_;
+    std::string version_;
+    std::map<std::string, std::string> headers_;
+    bool keep_alive_ = false;
+
+    // 返回true表示解析出一个完整请求
+    bool handle_input(std::string &input_buffer)
+    {
+        size_t header_end = input_buffer.find("\r\n\r\n");
+        if (header_end == std::string::npos)
+            return false;
+        if (!parse_request(input_buffer.substr(0, header_end + 4)))
+            return false;
+        input_buffer.erase(0, header_end + 4);
+        return true;
+    }
+
+    bool parse_request(const std::string &headers)
+    {
+        std::istringstream iss(headers);
+        std::string line;
+
+        if (!std::getline(iss, line) || line.back() != '\r')
+            return false;
+        line.pop_back();
+
+        std::istringstream req_line(line);
+        if (!(req_line >> method_ >> uri_ >> version_))
+            return false;
+
+        std::transform(method_.begin(), method_.end(), method_.begin(), ::toupper);
+
+        while (std::getline(iss, line) && line != "\r")
+        {
+            line.pop_back();
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+                continue;
+
+            std::string key = line.substr(0, colon);
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            headers_[key] = value;
+        }
+
+        keep_alive_ = (version_ == "HTTP/1.1");
+        if (headers_.count("Connection"))
+        {
+            keep_alive_ = (headers_["Connection"] == "keep-alive");
+        }
+        return true;
+    }
+};
+
+struct Result
+{
+    double ns_per_request;
+    double allocs_per_request;
+};
+
+// 每个请求按chunk字节分多次到达（0表示一次性到达）
+static Result run_legacy(const std::string &request, size_t chunk, size_t iterations)
+{
+    LegacyParser parser;
+    std::string buffer;
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        size_t step = chunk == 0 ? request.size() : chunk;
+        for (size_t pos = 0; pos < request.size(); pos += step)
+        {
+            buffer.append(request, pos, step);
+            parser.handle_input(buffer);
+        }
+        parser.headers_.clear();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+            static_cast<double>(g_allocations - allocations) / iterations};
+}
+
+static Result run_parser(const std::string &request, size_t chunk, size_t iterations)
+{
+    HTTPRequestParser parser;
+    std::string buffer;
+    size_t keep_alive = 0;
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        size_t step = chunk == 0 ? request.size() : chunk;
+        for (size_t pos = 0; pos < request.size(); pos += step)
+        {
+            buffer.append(request, pos, step);
+            if (parser.parse(buffer.data(), buffer.size()) == HTTPRequestParser::COMPLETE)
+            {
+                keep_alive += !http_iequals(parser.header("Connection"), "close");
+                buffer.erase(0, parser.head_length());
+                parser.reset();
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (keep_alive != iterations)
+    {
+        fprintf(stderr, "unexpected parse result\n");
+    }
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+            static_cast<double>(g_allocations - allocations) / iterations};
+}
+
+int main(int argc, char *argv[])
+{
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::string small = "GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    std::string browser =
+        "GET /static/app.js?v=3 HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+        "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Referer: https://www.example.com/\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "Sec-Fetch-Dest: script\r\n"
+        "Sec-Fetch-Mode: no-cors\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "If-None-Match: \"5f2b-1a2b3c\"\r\n\r\n";
+    std::string cookies = browser;
+    cookies.insert(cookies.size() - 2, "Cookie: " + std::string(4000, 'c') + "\r\n" +
+                                            "X-Forwarded-For: 10.0.0.1, 10.0.0.2, 10.0.0.3\r\n");
+
+    struct Case
+    {
+        const char *name;
+        const std::string *request;
+        size_t chunk;
+    };
+    const Case cases[] = {
+        {"small", &small, 0},
+        {"browser", &browser, 0},
+        {"cookies", &cookies, 0},
+        {"cookies/256B", &cookies, 256}, // 模拟分多次读取到达
+    };
+
+    const ScanKernel default_kernel = active_scan_kernel();
+    printf("default scan kernel: %s\n", scan_kernel_name(default_kernel));
+
+    printf("%-14s %-12s %12s %14s\n", "request", "parser", "ns/req", "allocs/req");
+    for (const Case &c : cases)
+    {
+        size_t n = c.chunk == 0 ? iterations : iterations / 10;
+        Result legacy = run_legacy(*c.request, c.chunk, n);
+        printf("%-14s %-12s %12.1f %14.2f\n", c.name, "legacy", legacy.ns_per_request, legacy.allocs_per_request);
+
+        for (ScanKernel kernel : {ScanKernel::SCALAR, ScanKernel::SSE42, ScanKernel::AVX2})
+        {
+            if (!select_scan_kernel(kernel))
+                continue;
+            Result parsed = run_parser(*c.request, c.chunk, n);
+            std::string name = std::string("new/") + scan_kernel_name(kernel);
+            printf("%-14s %-12s %12.1f %14.2f\n", c.name, name.c_str(), parsed.ns_per_request, parsed.allocs_per_request);
+        }
+        select_scan_kernel(default_kernel);
+    }
+    return 0;
+}
@@ -1,58 +1,134 @@
 #include "Epoll_Reactor.h"
 #include "../Logger/Logger.h"
 #include "../Master_Worker/master_worker.h"
+#include <algorithm>
+#include <csignal>
 
-EpollReactor::EpollReactor()
+// 各信号对应的自管道写端（fd+1，0表示未注册），供信号处理函数使用
+static std::atomic<int> g_signal_pipe_fds[NSIG];
+
+static void signal_pipe_handler(int signo)
+{
+    int saved_errno = errno;
+    int fd = g_signal_pipe_fds[signo].load(std::memory_order_relaxed) - 1;
+    if (fd >= 0)
+    {
+        unsigned char byte = static_cast<unsigned char>(signo);
+        ssize_t n = write(fd, &byte, 1);
+        (void)n;
+    }
+    errno = saved_errno;
+}
+
+EpollReactor::EpollReactor() : timers_(TimerWheel::now_ms())
 {
     epoll_fd_ = epoll_create1(0);
     if (epoll_fd_ == -1)
     {
         throw std::system_error(errno, std::generic_category(), "epoll_create1");
     }
-    Logger::get_instance().log(Logger::INFO,
-                               "Epoll instance created (epoll_fd_=" + std::to_string(epoll_fd_) + ")");
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ == -1)
+    {
+        close(epoll_fd_);
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    add_fd(wake_fd_, EPOLLIN, [this](uint32_t events)
+           {
+        uint64_t count;
+        ssize_t n = read(wake_fd_, &count, sizeof(count));
+        (void)n; });
+
+    LOG_DEBUG("Epoll instance created (epoll_fd_=" + std::to_string(epoll_fd_) + ")");
 }
 
 EpollReactor::~EpollReactor()
 {
+    // 恢复本reactor接管的信号的默认处理方式
+    for (size_t signo = 0; signo < signal_tasks_.size(); ++signo)
+    {
+        if (signal_tasks_[signo])
+        {
+            g_signal_pipe_fds[signo].store(0);
+            signal(static_cast<int>(signo), SIG_DFL);
+        }
+    }
+    if (signal_pipe_[0] >= 0)
+    {
+        close(signal_pipe_[0]);
+        close(signal_pipe_[1]);
+    }
+
+    // 丢弃未执行的任务
+    TaskNode *node = pending_tasks_.exchange(nullptr);
+    while (node != nullptr)
+    {
+        TaskNode *next = node->next;
+        delete node;
+        node = next;
+    }
+    close(wake_fd_);
+
     if (epoll_fd_ >= 0)
     {
-        Logger::get_instance().log(Logger::INFO,
-                                   "Closing epoll instance (epoll_fd_=" + std::to_string(epoll_fd_) + ")");
+        LOG_DEBUG("Closing epoll instance (epoll_fd_=" + std::to_string(epoll_fd_) + ")");
         // std::cerr << "Closing epoll instance fd=" << epoll_fd_ << "\n";
         close(epoll_fd_);
     }
 }
 
+void EpollReactor::add_fd(int fd, uint32_t events, EventHandler *handler)
+{
+    register_fd(fd, events, handler);
+}
+
 void EpollReactor::add_fd(int fd, uint32_t events, EventCallback cb)
+{
+    auto handler = std::make_unique<CallbackHandler>(std::move(cb));
+    register_fd(fd, events, handler.get());
+    callbacks_[fd] = std::move(handler);
+}
+
+void EpollReactor::register_fd(int fd, uint32_t events, EventHandler *handler)
 {
     epoll_event ev{};
     ev.events = events;
-    ev.data.fd = fd;
-
-    callbacks_.emplace(fd, std::move(cb)); // 将fd和回调函数cb加入callbacks_
+    ev.data.ptr = handler;
 
     if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1)
     {
-        Logger::get_instance().log(Logger::ERROR, "epoll_ctl add failed for fd=" + std::to_string(fd) + ": " + std::to_string(errno));
+        LOG_ERROR("epoll_ctl add failed for fd=" + std::to_string(fd) + ": " + std::to_string(errno));
         throw std::system_error(errno, std::generic_category(), "epoll_ctl add");
     }
+
+    if (static_cast<size_t>(fd) >= handlers_.size())
+    {
+        handlers_.resize(fd + 1, nullptr);
+        callbacks_.resize(fd + 1);
+    }
+    handlers_[fd] = handler;
 }
 
 void EpollReactor::modify_fd(int fd, uint32_t events)
 {
     if (fd < 0 || epoll_fd_ < 0)
     {
-        Logger::get_instance().log(Logger::WARNING,
-                                   "Attempt to modify invalid fd=" + std::to_string(fd) +
-                                       " (epoll_fd= " + std::to_string(epoll_fd_) + ")");
+        LOG_WARNING("Attempt to modify invalid fd=" + std::to_string(fd) +
+                    " (epoll_fd= " + std::to_string(epoll_fd_) + ")");
+
+        return;
+    }
 
+    if (static_cast<size_t>(fd) >= handlers_.size() || handlers_[fd] == nullptr)
+    {
+        LOG_WARNING("Attempt to modify unregistered fd=" + std::to_string(fd));
         return;
     }
 
     epoll_event ev{};
     ev.events = events;
-    ev.data.fd = fd;
+    ev.data.ptr = handlers_[fd];
 
     if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == -1)
     {
@@ -65,8 +141,8 @@ void EpollReactor::remove_fd(int fd)
 
     if (fd < 0 || epoll_fd_ < 0)
     {
-        Logger::get_instance().log(Logger::WARNING, "WARN: Attempt to remove invalid fd=" + std::to_string(fd) +
-                                                        " (epoll_fd=" + std::to_string(epoll_fd_) + ")");
+        LOG_WARNING("WARN: Attempt to remove invalid fd=" + std::to_string(fd) +
+                    " (epoll_fd=" + std::to_string(epoll_fd_) + ")");
 
         // std::cerr << "WARN: Attempt to remove invalid fd=" << fd
         //           << " (epoll_fd=" << epoll_fd_ << ")\n";
@@ -88,16 +164,39 @@ void EpollReactor::remove_fd(int fd)
 
         throw std::system_error(errno, std::generic_category(), "epoll_ctl del");
     }
-    callbacks_.erase(fd); // 从callbacks_中删除fd
+
+    if (static_cast<size_t>(fd) >= handlers_.size())
+    {
+        return;
+    }
+
+    // 处理事件期间移除：处理器可能正在执行或仍有待分发的事件，延迟到本批结束再释放
+    if (dispatching_)
+    {
+        removed_.push_back(handlers_[fd]);
+        if (callbacks_[fd])
+            retired_.push_back(std::move(callbacks_[fd]));
+    }
+    handlers_[fd] = nullptr;
+    callbacks_[fd].reset();
 }
 
 void EpollReactor::run(int max_events, int timeout_ms)
 {
     std::vector<epoll_event> events(max_events);
+    loop_thread_.store(std::this_thread::get_id());
 
     while (running_)
     {
-        int n = epoll_wait(epoll_fd_, events.data(), max_events, timeout_ms);
+        // 有定时器时等待到最近一个到期时刻
+        int wait_ms = timeout_ms;
+        int timer_ms = timers_.next_timeout(TimerWheel::now_ms());
+        if (timer_ms >= 0 && (wait_ms < 0 || timer_ms < wait_ms))
+        {
+            wait_ms = timer_ms;
+        }
+
+        int n = epoll_wait(epoll_fd_, events.data(), max_events, wait_ms);
         if (n == -1)
         {
             if (errno != EINTR)
@@ -108,39 +207,163 @@ void EpollReactor::run(int max_events, int timeout_ms)
             continue;
         }
 
+        dispatching_ = true;
         for (int i = 0; i < n; ++i)
         {
-            auto it = callbacks_.find(events[i].data.fd);
-            if (it != callbacks_.end())
+            auto *handler = static_cast<EventHandler *>(events[i].data.ptr);
+            // 跳过本批中已被移除的处理器（其对象可能已被回收复用）
+            if (!removed_.empty() && std::find(removed_.begin(), removed_.end(), handler) != removed_.end())
             {
-                it->second(events[i].events);
+                continue;
             }
+            handler->handle_event(events[i].events);
         }
+        dispatching_ = false;
+
+        removed_.clear();
+        retired_.clear();
+
+        timers_.advance(TimerWheel::now_ms());
+        run_pending_tasks();
     }
+
+    loop_thread_.store(std::thread::id());
 }
 
 void EpollReactor::stop()
 {
-    if (running_)
+    running_.store(false);
+    wakeup();
+}
+
+void EpollReactor::wakeup()
+{
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+}
+
+void EpollReactor::post(Task task)
+{
+    TaskNode *node = new TaskNode{std::move(task), pending_tasks_.load(std::memory_order_relaxed)};
+    while (!pending_tasks_.compare_exchange_weak(node->next, node,
+                                                 std::memory_order_release, std::memory_order_relaxed))
     {
-        running_ = false;
+    }
+
+    // 只有压入空栈的生产者负责唤醒，之后的任务会在同一批中被取走
+    if (node->next == nullptr)
+    {
+        wakeup();
     }
 }
 
-// TCP连接处理，工厂函数
-std::shared_ptr<TcpConnection> TcpConnection::create(int fd, EpollReactor &reactor)
+void EpollReactor::run_in_loop(Task task)
 {
-    return std::shared_ptr<TcpConnection>(new TcpConnection(fd, reactor));
+    if (in_loop_thread())
+    {
+        task();
+    }
+    else
+    {
+        post(std::move(task));
+    }
 }
 
-TcpConnection::TcpConnection(int fd, EpollReactor &reactor)
-    : fd_(fd), reactor_(reactor)
+bool EpollReactor::in_loop_thread() const
+{
+    return loop_thread_.load() == std::this_thread::get_id();
+}
+
+void EpollReactor::run_pending_tasks()
+{
+    TaskNode *node = pending_tasks_.exchange(nullptr, std::memory_order_acquire);
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    // 栈中为后进先出，反转后按投递顺序执行
+    TaskNode *ordered = nullptr;
+    while (node != nullptr)
+    {
+        TaskNode *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    while (ordered != nullptr)
+    {
+        TaskNode *next = ordered->next;
+        ordered->task();
+        delete ordered;
+        ordered = next;
+    }
+}
+
+void EpollReactor::add_timer(TimerNode &node, uint64_t delay_ms)
+{
+    timers_.schedule(node, delay_ms, TimerWheel::now_ms());
+}
+
+void EpollReactor::cancel_timer(TimerNode &node)
+{
+    timers_.cancel(node);
+}
+
+void EpollReactor::handle_signal(int signo, Task task)
+{
+    if (signal_pipe_[0] == -1)
+    {
+        if (pipe2(signal_pipe_, O_NONBLOCK | O_CLOEXEC) == -1)
+        {
+            throw std::system_error(errno, std::generic_category(), "pipe2");
+        }
+        add_fd(signal_pipe_[0], EPOLLIN, [this](uint32_t events)
+               { read_signals(); });
+        signal_tasks_.resize(NSIG);
+    }
+
+    signal_tasks_[signo] = std::move(task);
+    g_signal_pipe_fds[signo].store(signal_pipe_[1] + 1);
+
+    struct sigaction sa;
+    sa.sa_handler = signal_pipe_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(signo, &sa, nullptr) == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "sigaction");
+    }
+}
+
+void EpollReactor::read_signals()
+{
+    unsigned char signals[64];
+    ssize_t n;
+    while ((n = read(signal_pipe_[0], signals, sizeof(signals))) > 0)
+    {
+        for (ssize_t i = 0; i < n; ++i)
+        {
+            if (signals[i] < signal_tasks_.size() && signal_tasks_[signals[i]])
+            {
+                signal_tasks_[signals[i]]();
+            }
+        }
+    }
+}
+
+TcpConnection::TcpConnection(EpollReactor &reactor)
+    : reactor_(reactor), timer_([this]
+                                { handle_timeout(); })
 {
-    set_nonblocking(fd_);
 }
 
 TcpConnection::~TcpConnection()
 {
+    reactor_.cancel_timer(timer_);
+
     if (fd_ >= 0)
     {
         shutdown(fd_, SHUT_RDWR); // 关闭读写端
@@ -148,13 +371,44 @@ TcpConnection::~TcpConnection()
     }
 }
 
-void TcpConnection::start()
+void TcpConnection::open(int fd)
+{
+    fd_ = fd;
+    set_nonblocking(fd_);
+
+    // 复用上一个连接的缓冲区，避免每个连接重新分配；过大的缓冲区则释放
+    if (input_buffer_.capacity() > kMaxRetainedBuffer)
+        std::string().swap(input_buffer_);
+    input_buffer_.clear();
+    output_queue_.clear();
+    output_head_ = output_offset_ = 0;
+
+    reading_ = false;
+    writing_ = false;
+    wait_writable_ = false;
+    keep_alive_ = false;
+    write_progress_ = false;
+
+    arm_timer(TIMER_HEADER); // 新连接须在限定时间内发来请求头
+}
+
+void TcpConnection::start(EventHandler *handler)
+{
+    add_ref(); // 由handle_close释放
+    reactor_.add_fd(fd_, EPOLLIN | EPOLLET, handler);
+}
+
+void TcpConnection::release()
 {
-    reactor_.add_fd(fd_, EPOLLIN | EPOLLET,
-                    [self = shared_from_this()](uint32_t events)
-                    {
-                        self->handle_event(events);
-                    });
+    if (--refs_ == 0 && release_cb_)
+    {
+        release_cb_(*this);
+    }
+}
+
+void TcpConnection::set_release_callback(ReleaseCallback cb)
+{
+    release_cb_ = std::move(cb);
 }
 
 void TcpConnection::set_read_callback(ReadCallback cb)
@@ -164,9 +418,22 @@ void TcpConnection::set_read_callback(ReadCallback cb)
 
 void TcpConnection::send(const std::string &data)
 {
-    output_buffer_ += data;
-    if (!writing_)
+    send(std::string(data));
+}
+
+void TcpConnection::send(std::string &&data)
+{
+    if (fd_ == -1 || data.empty())
+    {
+        return; // 连接已关闭
+    }
+
+    output_queue_.push_back(std::move(data));
+
+    // 读回调中产生的响应由do_read统一写出；其余情况等待可写事件
+    if (!reading_ && !writing_ && !wait_writable_)
     {
+        wait_writable_ = true;
         reactor_.modify_fd(fd_, EPOLLIN | EPOLLOUT | EPOLLET);
     }
 }
@@ -175,17 +442,65 @@ void TcpConnection::handle_event(uint32_t events)
 {
     if (events & EPOLLIN)
         do_read();
-    if (events & EPOLLOUT)
+    if ((events & EPOLLOUT) && fd_ != -1)
         do_write();
     if (events & (EPOLLERR | EPOLLHUP))
         handle_close();
+
+    update_timer();
+}
+
+void TcpConnection::arm_timer(TimerKind kind)
+{
+    static const uint64_t timeouts[] = {0, kHeaderTimeoutMs, kIdleTimeoutMs, kWriteStallTimeoutMs};
+    timer_kind_ = kind;
+    reactor_.add_timer(timer_, timeouts[kind]);
+}
+
+void TcpConnection::update_timer()
+{
+    if (fd_ == -1)
+    {
+        return;
+    }
+
+    bool progressed = write_progress_;
+    write_progress_ = false;
+
+    if (output_pending())
+    {
+        // 写超时只在有数据写出时顺延
+        if (timer_kind_ != TIMER_WRITE || progressed)
+            arm_timer(TIMER_WRITE);
+    }
+    else if (!input_buffer_.empty())
+    {
+        // 请求头截止时间从收到首个字节起算，逐字节慢速发送不会顺延
+        if (timer_kind_ != TIMER_HEADER)
+            arm_timer(TIMER_HEADER);
+    }
+    else if (timer_kind_ != TIMER_HEADER || progressed)
+    {
+        // 响应已发完，进入空闲等待；新连接尚未发来任何数据时保持请求头超时
+        arm_timer(TIMER_IDLE);
+    }
+}
+
+void TcpConnection::handle_timeout()
+{
+    static const char *const names[] = {"none", "header", "idle", "write"};
+    LOG_DEBUG("Connection fd=" + std::to_string(fd_) + " " + names[timer_kind_] + " timeout");
+
+    timer_kind_ = TIMER_NONE;
+    add_ref(); // 关闭时槽位可能被回收，持有引用直到处理结束
+    handle_close();
+    release();
 }
 
 void TcpConnection::do_read()
 {
-    Logger::get_instance().log(Logger::INFO,
-                               "Worker " + std::to_string(getpid()) +
-                                   " reading fd=" + std::to_string(fd_));
+    LOG_TRACE("Worker " + std::to_string(getpid()) +
+              " reading fd=" + std::to_string(fd_));
 
     char buf[8192];
     ssize_t n;
@@ -195,61 +510,93 @@ void TcpConnection::do_read()
         input_buffer_.append(buf, n);
     }
 
-    if (n == 0)
-    {
-        handle_close();
-    }
-    else if (n == -1 && errno != EAGAIN)
+    if (n == 0 || (n == -1 && errno != EAGAIN))
     {
         handle_close();
+        return; // 连接已关闭，不再处理请求
     }
 
     if (read_cb_)
     {
+        // 由上层从缓冲区中取走已处理的数据，不完整的请求保留到下次读取
+        reading_ = true;
         read_cb_(input_buffer_);
-        input_buffer_.clear();
+        reading_ = false;
+    }
+
+    // 本次读到的所有（流水线）请求的响应合并为一次writev
+    if (fd_ != -1 && output_pending())
+    {
+        do_write();
     }
 }
 
 void TcpConnection::do_write()
 {
-    Logger::get_instance().log(Logger::INFO,
-                               "Worker " + std::to_string(getpid()) +
-                                   " writing fd=" + std::to_string(fd_));
+    LOG_TRACE("Worker " + std::to_string(getpid()) +
+              " writing fd=" + std::to_string(fd_));
+
+    if (!output_pending() && !wait_writable_)
+    {
+        return; // 没有待发送的数据
+    }
 
     writing_ = true; // 标记写入状态，防止重入
 
     // 边缘触发模式下，循环写入数据
-    while (!output_buffer_.empty())
+    while (output_pending())
     {
-        ssize_t n = ::write(fd_, output_buffer_.data(), output_buffer_.size());
+        struct iovec iov[kMaxWriteSegments];
+        int count = 0;
+        for (size_t i = output_head_; i < output_queue_.size() && count < kMaxWriteSegments; ++i, ++count)
+        {
+            size_t skip = (i == output_head_) ? output_offset_ : 0;
+            iov[count].iov_base = const_cast<char *>(output_queue_[i].data()) + skip;
+            iov[count].iov_len = output_queue_[i].size() - skip;
+        }
+
+        ssize_t n = ::writev(fd_, iov, count);
 
         if (n > 0)
         {
-            output_buffer_.erase(0, n); // 移除已发送数据
+            write_progress_ = true;
+            consume_output(n); // 移除已发送数据
             continue;
         }
 
-        if (n == -1)
+        if (n == -1 && errno == EINTR)
         {
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            continue;
+        }
+
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            // 内核缓冲区已满，需要等待下次可写事件
+            if (!wait_writable_)
             {
-                // 内核缓冲区已满，需要等待下次可写事件
+                wait_writable_ = true;
                 reactor_.modify_fd(fd_, EPOLLIN | EPOLLOUT | EPOLLET);
             }
-            else
-            {
-                handle_close(); // 发生实际错误，关闭连接
-            }
-            break; // 退出循环
+            break;
         }
+
+        handle_close(); // 发生实际错误，关闭连接
+        writing_ = false;
+        return;
     }
 
     // 根据缓冲区状态调整监听事件
-    if (output_buffer_.empty())
+    if (!output_pending())
     {
+        output_queue_.clear();
+        output_head_ = output_offset_ = 0;
+
         // 数据已全部发送，停止监听写事件
-        reactor_.modify_fd(fd_, EPOLLIN | EPOLLET);
+        if (wait_writable_)
+        {
+            wait_writable_ = false;
+            reactor_.modify_fd(fd_, EPOLLIN | EPOLLET);
+        }
 
         // 非keep-alive连接，立即关闭
         if (!keep_alive_)
@@ -261,6 +608,23 @@ void TcpConnection::do_write()
     writing_ = false; // 重置写入状态
 }
 
+void TcpConnection::consume_output(size_t n)
+{
+    while (n > 0)
+    {
+        size_t left = output_queue_[output_head_].size() - output_offset_;
+        if (n < left)
+        {
+            output_offset_ += n;
+            return;
+        }
+        n -= left;
+        std::string().swap(output_queue_[output_head_]); // 已发完的分段立即释放
+        output_head_++;
+        output_offset_ = 0;
+    }
+}
+
 void TcpConnection::handle_close()
 {
     if (fd_ == -1)
@@ -268,13 +632,17 @@ void TcpConnection::handle_close()
         return;
     }
 
-    Logger::get_instance().log(Logger::INFO, "Closing connection fd=" + std::to_string(fd_));
+    LOG_DEBUG("Closing connection fd=" + std::to_string(fd_));
+
+    reactor_.cancel_timer(timer_);
+    timer_kind_ = TIMER_NONE;
 
     reactor_.remove_fd(fd_);
     shutdown(fd_, SHUT_RDWR);
     close(fd_);
 
     fd_ = -1;
+    release(); // 释放注册时持有的引用
 }
 
 void TcpConnection::set_nonblocking(int fd)
@@ -292,9 +660,11 @@ void TcpConnection::set_keep_alive(bool keep_alive)
 TcpAcceptor::TcpAcceptor(EpollReactor &reactor, uint16_t listen_fd)
     : reactor_(reactor), listen_fd_(listen_fd)
 {
-    reactor_.add_fd(listen_fd_, EPOLLIN | EPOLLET,
-                    [this](uint32_t events)
-                    { handle_accept(); });
+    // 边缘触发下需循环accept直到EAGAIN，监听套接字必须为非阻塞
+    int flags = fcntl(listen_fd_, F_GETFL, 0);
+    fcntl(listen_fd_, F_SETFL, flags | O_NONBLOCK);
+
+    reactor_.add_fd(listen_fd_, EPOLLIN | EPOLLET, this);
 }
 
 TcpAcceptor::~TcpAcceptor()
@@ -308,6 +678,11 @@ void TcpAcceptor::set_new_connection_callback(NewConnectionCallback cb)
     new_conn_cb_ = std::move(cb);
 }
 
+void TcpAcceptor::handle_event(uint32_t events)
+{
+    handle_accept();
+}
+
 void TcpAcceptor::handle_accept()
 {
     sockaddr_in client_addr{};
@@ -321,12 +696,11 @@ void TcpAcceptor::handle_accept()
         {
             if (errno == EAGAIN || errno == EWOULDBLOCK)
                 break;
-            Logger::get_instance().log(Logger::ERROR,
-                                       "Accept error: " + errno);
+            LOG_ERROR("Accept error: " + std::to_string(errno));
             break;
         }
 
-        Logger::get_instance().log(Logger::INFO, "Accepted new connection fd=" + std::to_string(conn_fd) + " by worker " + std::to_string(getpid()));
+        LOG_DEBUG("Accepted new connection fd=" + std::to_string(conn_fd) + " by worker " + std::to_string(getpid()));
 
         // 设置SO_LINGER选项，以优雅地关闭连接
         struct linger linger_opts = {1, 1};
@@ -4,24 +4,35 @@
 #include <sys/eventfd.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <memory>
 #include <functional>
-#include <unordered_map>
 #include <system_error>
 #include <string>
 #include <iostream>
 #include <vector>
 #include <atomic>
+#include <thread>
+#include "Timer_Wheel.h"
 
 class ProcessMaster;
 
+// 事件处理器接口：注册时指针存入epoll_event.data.ptr，事件就绪时直接虚函数调用
+class EventHandler
+{
+public:
+    virtual ~EventHandler() = default;
+    virtual void handle_event(uint32_t events) = 0;
+};
+
 class EpollReactor
 {
 public:
     using EventCallback = std::function<void(uint32_t events)>; // 事件回调函数别名
+    using Task = std::function<void()>;                         // 投递到事件循环线程执行的任务
 
     EpollReactor();
     ~EpollReactor();
@@ -29,57 +40,142 @@ public:
     EpollReactor(const EpollReactor &) = delete;
     EpollReactor &operator=(const EpollReactor &) = delete;
 
-    void add_fd(int fd, uint32_t events, EventCallback cb); // 添加fd到epoll监听
-    void modify_fd(int fd, uint32_t events);                // 修改fd的监听事件
-    void remove_fd(int fd);                                 // 移除fd
-    void run(int max_events = 4096, int timeout_ms = -1);   // 开始事件循环
-    void stop(); // 停止事件循环
+    void add_fd(int fd, uint32_t events, EventHandler *handler); // 添加fd到epoll监听，处理器由调用方持有
+    void add_fd(int fd, uint32_t events, EventCallback cb);      // 添加fd到epoll监听，回调由reactor持有
+    void modify_fd(int fd, uint32_t events);                     // 修改fd的监听事件
+    void remove_fd(int fd);                                      // 移除fd
+    void run(int max_events = 4096, int timeout_ms = -1);        // 开始事件循环
+    void stop(); // 停止事件循环，可在任意线程及信号处理函数中调用，立即唤醒epoll_wait
+
+    void post(Task task);                     // 任意线程投递任务，在事件循环线程中执行
+    void run_in_loop(Task task);              // 已在事件循环线程内则立即执行，否则投递
+    bool in_loop_thread() const;
+    void handle_signal(int signo, Task task); // 信号经自管道转入事件循环，在循环线程内执行task
+
+    // 定时器（仅限事件循环线程）：到期回调在事件循环中执行
+    void add_timer(TimerNode &node, uint64_t delay_ms); // 已定时的节点会重新定时
+    void cancel_timer(TimerNode &node);
 
 private:
-    std::unordered_map<int, EventCallback> callbacks_;  // 事件回调存储容器
+    // 将std::function回调适配为EventHandler
+    class CallbackHandler : public EventHandler
+    {
+    public:
+        explicit CallbackHandler(EventCallback cb) : cb_(std::move(cb)) {}
+        void handle_event(uint32_t events) override { cb_(events); }
+
+    private:
+        EventCallback cb_;
+    };
+
+    // 无锁多生产者单消费者任务栈：生产者CAS压入，循环线程一次取走整批
+    struct TaskNode
+    {
+        Task task;
+        TaskNode *next;
+    };
+
+    void register_fd(int fd, uint32_t events, EventHandler *handler);
+    void wakeup();             // 写eventfd唤醒epoll_wait（异步信号安全）
+    void run_pending_tasks();  // 取出并执行本轮之前投递的全部任务
+    void read_signals();       // 读取自管道中的信号并执行对应任务
+
+    std::vector<EventHandler *> handlers_;                       // 按fd索引的已注册处理器
+    std::vector<std::unique_ptr<CallbackHandler>> callbacks_;    // 按fd索引，reactor持有的回调
+    std::vector<EventHandler *> removed_;                        // 本批事件中已移除的处理器，跳过其剩余事件
+    std::vector<std::unique_ptr<CallbackHandler>> retired_;      // 本批事件中移除的回调，批次结束后释放
+    bool dispatching_ = false;
     int epoll_fd_ = -1;
     std::atomic<bool> running_{true}; // 控制事件循环
+
+    int wake_fd_ = -1;                           // eventfd，用于跨线程唤醒
+    std::atomic<TaskNode *> pending_tasks_{nullptr};
+    std::atomic<std::thread::id> loop_thread_{}; // 正在运行事件循环的线程
+
+    TimerWheel timers_; // epoll_wait的超时时间由最近的定时器决定
+
+    int signal_pipe_[2] = {-1, -1}; // 自管道：信号处理函数写入信号编号
+    std::vector<Task> signal_tasks_; // 按信号编号索引
 };
 
-class TcpConnection : public std::enable_shared_from_this<TcpConnection>
+// TCP连接：由连接池复用，侵入式引用计数，计数归零时交还连接池
+class TcpConnection
 {
 public:
-    using ReadCallback = std::function<void(std::string &)>; // 读回调函数
+    using ReadCallback = std::function<void(std::string &)>;         // 读回调函数
+    using ReleaseCallback = std::function<void(TcpConnection &)>;    // 引用计数归零时的回收函数
 
-    static std::shared_ptr<TcpConnection> create(int fd, EpollReactor &reactor);
+    explicit TcpConnection(EpollReactor &reactor);
     ~TcpConnection();
 
     TcpConnection(const TcpConnection &) = delete;
     TcpConnection &operator=(const TcpConnection &) = delete;
 
-    void start();
+    void open(int fd);                // 接管新accept的fd，复用已有缓冲区
+    void start(EventHandler *handler); // 注册到reactor，注册期间持有一个引用
     void set_read_callback(ReadCallback cb);
-    void send(const std::string &data); // 设置响应数据，准备发送
+    void set_release_callback(ReleaseCallback cb);
+    void send(const std::string &data); // 响应数据追加到发送队列
+    void send(std::string &&data);
     void handle_close();
+    void handle_event(uint32_t events);
     void set_keep_alive(bool keep_alive); // 设置是否保持连接
 
+    static constexpr uint64_t kHeaderTimeoutMs = 10000;     // 新连接或已收到部分请求：须在此时间内收齐请求头
+    static constexpr uint64_t kIdleTimeoutMs = 60000;       // keep-alive连接空闲超时
+    static constexpr uint64_t kWriteStallTimeoutMs = 30000; // 响应未发完且无进展的超时
+
+    void add_ref() { ++refs_; }
+    void release();
+
     int fd() const { return fd_; }
 
 private:
-    TcpConnection(int fd, EpollReactor &reactor);
-
-    void handle_event(uint32_t events);
     void do_read();  // 读事件处理
-    void do_write(); // 写事件处理
+    void do_write(); // 写事件处理：用writev一次写出队列中的全部响应
+    bool output_pending() const { return output_head_ < output_queue_.size(); }
+    void consume_output(size_t n); // 跳过已写出的n字节
     static void set_nonblocking(int fd);
 
+    enum TimerKind
+    {
+        TIMER_NONE,
+        TIMER_HEADER,
+        TIMER_IDLE,
+        TIMER_WRITE
+    };
+    void arm_timer(TimerKind kind);
+    void update_timer(); // 每次事件处理后按连接状态切换超时类型
+    void handle_timeout();
+
+    static constexpr size_t kMaxRetainedBuffer = 64 * 1024; // 复用时保留的最大缓冲区容量
+    static constexpr int kMaxWriteSegments = 64;            // 单次writev的最大分段数
+
     int fd_ = -1;
     EpollReactor &reactor_;
+    uint32_t refs_ = 0; // 单reactor线程内使用，无需原子操作
+
+    std::string input_buffer_; // 输入缓冲区
 
-    std::string input_buffer_;  // 输入缓冲区
-    std::string output_buffer_; // 输出缓冲区
+    // 发送队列：每个响应一段，按请求顺序排列；[output_head_, size)为未发完的部分
+    std::vector<std::string> output_queue_;
+    size_t output_head_ = 0;
+    size_t output_offset_ = 0; // 队首分段中已写出的字节数
 
+    bool reading_ = false;        // 正在执行读回调，期间的响应攒到回调结束后一起写出
     bool writing_ = false;
+    bool wait_writable_ = false;  // 是否已监听EPOLLOUT
     bool keep_alive_ = false;
+    bool write_progress_ = false; // 上次更新定时器后是否有数据写出
+
+    TimerNode timer_;
+    TimerKind timer_kind_ = TIMER_NONE;
+
     ReadCallback read_cb_;
+    ReleaseCallback release_cb_;
 };
 
-class TcpAcceptor
+class TcpAcceptor : public EventHandler
 {
 public:
     using NewConnectionCallback = std::function<void(int fd)>; // 新连接回调函数
@@ -91,6 +187,7 @@ public:
     TcpAcceptor &operator=(const TcpAcceptor &) = delete;
 
     void set_new_connection_callback(NewConnectionCallback cb);
+    void handle_event(uint32_t events) override;
 
 private:
     void handle_accept();   // 处理新连接
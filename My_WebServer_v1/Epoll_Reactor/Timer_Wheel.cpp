@@ -0,0 +1,193 @@
+#include "Timer_Wheel.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+TimerWheel::TimerWheel(uint64_t now_ms) : current_(now_ms)
+{
+}
+
+uint64_t TimerWheel::now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void TimerWheel::schedule(TimerNode &node, uint64_t delay_ms, uint64_t now_ms)
+{
+    if (node.armed_)
+    {
+        unlink(node);
+    }
+
+    node.expire_ = now_ms + std::min(delay_ms, kMaxDelay);
+    add(node);
+    count_++;
+}
+
+void TimerWheel::cancel(TimerNode &node)
+{
+    if (node.armed_)
+    {
+        unlink(node);
+    }
+}
+
+void TimerWheel::add(TimerNode &node)
+{
+    if (node.expire_ < current_)
+    {
+        node.expire_ = current_; // 已到期，在下一刻处理
+    }
+
+    uint64_t delta = node.expire_ - current_;
+    TimerNode **head;
+    if (delta < kRootSize)
+    {
+        node.level_ = 0;
+        node.slot_ = static_cast<uint8_t>(node.expire_ & (kRootSize - 1));
+        head = &root_[node.slot_];
+        root_bitmap_[node.slot_ / 64] |= 1ull << (node.slot_ % 64);
+    }
+    else
+    {
+        if (delta > kMaxDelay)
+        {
+            node.expire_ = current_ + kMaxDelay;
+            delta = kMaxDelay;
+        }
+
+        int level = 1;
+        while (level < kLevels - 1 && delta >= (1ull << shift(level + 1)))
+        {
+            level++;
+        }
+        node.level_ = static_cast<uint8_t>(level);
+        node.slot_ = static_cast<uint8_t>((node.expire_ >> shift(level)) & (kLevelSize - 1));
+        head = &levels_[level - 1][node.slot_];
+        level_bitmap_[level - 1] |= 1ull << node.slot_;
+    }
+
+    node.prev_ = nullptr;
+    node.next_ = *head;
+    if (*head != nullptr)
+    {
+        (*head)->prev_ = &node;
+    }
+    *head = &node;
+    node.armed_ = true;
+}
+
+void TimerWheel::unlink(TimerNode &node)
+{
+    TimerNode **head = node.level_ == 0 ? &root_[node.slot_] : &levels_[node.level_ - 1][node.slot_];
+
+    if (node.prev_ != nullptr)
+        node.prev_->next_ = node.next_;
+    else
+        *head = node.next_;
+    if (node.next_ != nullptr)
+        node.next_->prev_ = node.prev_;
+
+    if (*head == nullptr)
+    {
+        if (node.level_ == 0)
+            root_bitmap_[node.slot_ / 64] &= ~(1ull << (node.slot_ % 64));
+        else
+            level_bitmap_[node.level_ - 1] &= ~(1ull << node.slot_);
+    }
+
+    node.prev_ = node.next_ = nullptr;
+    node.armed_ = false;
+    count_--;
+}
+
+void TimerWheel::cascade(int level, uint64_t index)
+{
+    TimerNode *node = levels_[level - 1][index];
+    levels_[level - 1][index] = nullptr;
+    level_bitmap_[level - 1] &= ~(1ull << index);
+
+    while (node != nullptr)
+    {
+        TimerNode *next = node->next_;
+        add(*node);
+        node = next;
+    }
+}
+
+void TimerWheel::expire_slot(uint64_t index)
+{
+    // 每次从槽位头部取节点：回调中取消或新增其他定时器都是安全的
+    while (TimerNode *node = root_[index])
+    {
+        unlink(*node);
+        if (node->cb_)
+        {
+            node->cb_(); // 回调返回后不再访问节点，回调内可重新定时或销毁其所属对象
+        }
+    }
+}
+
+uint64_t TimerWheel::next_root_slot(uint64_t index) const
+{
+    for (uint64_t word = index / 64; word < kRootSize / 64; ++word)
+    {
+        uint64_t bits = root_bitmap_[word];
+        if (word == index / 64)
+        {
+            bits &= ~0ull << (index % 64);
+        }
+        if (bits != 0)
+        {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+    return kRootSize;
+}
+
+void TimerWheel::advance(uint64_t now_ms)
+{
+    while (current_ <= now_ms)
+    {
+        uint64_t index = current_ & (kRootSize - 1);
+        if (root_[index] != nullptr)
+        {
+            expire_slot(index);
+        }
+
+        // 跳过空槽：直接前进到下一个非空槽位、第0层的下一圈或now_ms之后
+        uint64_t next = index + 1 < kRootSize ? next_root_slot(index + 1) : kRootSize;
+        current_ += std::min(next - index, now_ms + 1 - current_);
+
+        // 进入第0层新的一圈：立即逐级将高层槽位下放，保证next_timeout()看到的第0层是完整的
+        if ((current_ & (kRootSize - 1)) == 0)
+        {
+            for (int level = 1; level < kLevels; ++level)
+            {
+                uint64_t level_index = (current_ >> shift(level)) & (kLevelSize - 1);
+                cascade(level, level_index);
+                if (level_index != 0)
+                    break;
+            }
+        }
+    }
+}
+
+int TimerWheel::next_timeout(uint64_t now_ms) const
+{
+    if (count_ == 0)
+    {
+        return -1;
+    }
+
+    // 下一个非空槽位；第0层后面全空时，需要在下一次下放时重新计算
+    uint64_t index = current_ & (kRootSize - 1);
+    uint64_t target = current_ + (next_root_slot(index) - index);
+    if (target <= now_ms)
+    {
+        return 0;
+    }
+    return static_cast<int>(std::min<uint64_t>(target - now_ms, INT_MAX));
+}
@@ -0,0 +1,79 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// 侵入式定时器节点：嵌入到使用者对象中，定时、取消都不分配内存
+class TimerNode
+{
+public:
+    using Callback = std::function<void()>;
+
+    TimerNode() = default;
+    explicit TimerNode(Callback cb) : cb_(std::move(cb)) {}
+
+    TimerNode(const TimerNode &) = delete;
+    TimerNode &operator=(const TimerNode &) = delete;
+
+    void set_callback(Callback cb) { cb_ = std::move(cb); }
+    bool armed() const { return armed_; }
+
+private:
+    friend class TimerWheel;
+
+    TimerNode *prev_ = nullptr;
+    TimerNode *next_ = nullptr;
+    uint64_t expire_ = 0; // 到期时刻（毫秒刻度）
+    uint8_t level_ = 0;
+    uint8_t slot_ = 0;
+    bool armed_ = false;
+    Callback cb_;
+};
+
+// 分层时间轮：1ms一格，第0层256格，第1~3层各64格，最长约18.6小时（更长的定时按最大值处理）
+// 定时与取消均为O(1)；推进时借助每层的位图跳过空槽，高层槽位在低层转满一圈时逐级下放
+class TimerWheel
+{
+public:
+    explicit TimerWheel(uint64_t now_ms);
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    void schedule(TimerNode &node, uint64_t delay_ms, uint64_t now_ms); // 已定时的节点会重新定时
+    void cancel(TimerNode &node);
+    void advance(uint64_t now_ms);           // 执行所有到期的定时器回调
+    int next_timeout(uint64_t now_ms) const; // 距下次需要推进的毫秒数，无定时器返回-1
+
+    size_t size() const { return count_; }
+
+    static uint64_t now_ms(); // 单调时钟毫秒数
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kRootBits = 8;
+    static constexpr int kLevelBits = 6;
+    static constexpr uint64_t kRootSize = 1u << kRootBits;
+    static constexpr uint64_t kLevelSize = 1u << kLevelBits;
+    static constexpr uint64_t kMaxDelay = (1ull << (kRootBits + (kLevels - 1) * kLevelBits)) - 1;
+
+    void add(TimerNode &node);                  // 按到期时刻放入对应层的槽位
+    void unlink(TimerNode &node);
+    void cascade(int level, uint64_t index);    // 将高层槽位中的节点重新分配到低层
+    void expire_slot(uint64_t index);           // 执行第0层一个槽位中的全部定时器
+    uint64_t next_root_slot(uint64_t index) const; // 从index起第0层第一个非空槽位，没有返回kRootSize
+
+    static int shift(int level) { return level == 0 ? 0 : kRootBits + (level - 1) * kLevelBits; }
+
+    TimerNode *root_[kRootSize] = {};
+    TimerNode *levels_[kLevels - 1][kLevelSize] = {};
+    uint64_t root_bitmap_[kRootSize / 64] = {};
+    uint64_t level_bitmap_[kLevels - 1] = {};
+
+    uint64_t current_; // 下一个待处理的刻度
+    size_t count_ = 0;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "Connection_Pool.h"
+#include "../Logger/Logger.h"
+#include <new>
+
+ConnectionPool::Slot::Slot(EpollReactor &reactor, const std::string &root_dir)
+    : tcp(reactor), http(tcp, root_dir)
+{
+}
+
+void ConnectionPool::Slot::handle_event(uint32_t events)
+{
+    // 处理期间持有引用：回调内关闭连接时槽位要等处理结束才回收
+    tcp.add_ref();
+    tcp.handle_event(events);
+    tcp.release();
+}
+
+ConnectionPool::ConnectionPool(EpollReactor &reactor, std::string root_dir)
+    : reactor_(reactor), root_dir_(std::move(root_dir))
+{
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    for (uint32_t i = 0; i < constructed_; ++i)
+    {
+        slot(i).~Slot(); // 仍打开的连接由TcpConnection析构时关闭
+    }
+}
+
+ConnectionPool::Slot &ConnectionPool::slot(uint32_t index)
+{
+    Slab &slab = *slabs_[index / kSlabSlots];
+    return *reinterpret_cast<Slot *>(slab.storage + sizeof(Slot) * (index % kSlabSlots));
+}
+
+uint32_t ConnectionPool::allocate_slot()
+{
+    if (free_head_ != kNoSlot)
+    {
+        uint32_t index = free_head_;
+        free_head_ = slot(index).next_free;
+        return index;
+    }
+
+    if (constructed_ == capacity())
+    {
+        slabs_.push_back(std::make_unique<Slab>());
+        LOG_DEBUG("Connection pool grown to " + std::to_string(capacity()) + " slots");
+    }
+
+    // 槽位首次使用时构造，回调只设置一次，之后随槽位复用
+    uint32_t index = constructed_++;
+    Slot *s = new (&slot(index)) Slot(reactor_, root_dir_);
+    HTTPConnection *http = &s->http;
+    s->tcp.set_read_callback([http](std::string &buf)
+                             { http->handle_input(buf); });
+    s->tcp.set_release_callback([this, index](TcpConnection &)
+                                { recycle(index); });
+    return index;
+}
+
+ConnectionHandle ConnectionPool::open(int fd)
+{
+    uint32_t index = allocate_slot();
+    Slot &s = slot(index);
+    s.in_use = true;
+    in_use_.fetch_add(1, std::memory_order_relaxed);
+
+    s.tcp.open(fd);
+    s.http.reset();
+
+    s.tcp.start(&s);
+    return ConnectionHandle{index, s.generation};
+}
+
+TcpConnection *ConnectionPool::get(ConnectionHandle handle)
+{
+    if (handle.index >= constructed_)
+    {
+        return nullptr;
+    }
+
+    Slot &s = slot(handle.index);
+    if (!s.in_use || s.generation != handle.generation)
+    {
+        return nullptr;
+    }
+    return &s.tcp;
+}
+
+void ConnectionPool::recycle(uint32_t index)
+{
+    Slot &s = slot(index);
+    s.in_use = false;
+    ++s.generation;
+    s.next_free = free_head_;
+    free_head_ = index;
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+}
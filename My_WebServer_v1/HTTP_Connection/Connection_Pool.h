@@ -0,0 +1,70 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include "HTTP_Connection.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 连接句柄：槽位下标 + 代数。槽位回收时代数加一，旧句柄随之失效
+// （同一批epoll事件中已关闭连接的剩余事件由EpollReactor跳过）
+struct ConnectionHandle
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+// 每个reactor一个连接池：按slab成组分配TcpConnection+HTTPConnection，
+// 连接关闭且引用计数归零后槽位放回空闲链表，对象与缓冲区原地复用
+class ConnectionPool
+{
+public:
+    ConnectionPool(EpollReactor &reactor, std::string root_dir);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool &) = delete;
+    ConnectionPool &operator=(const ConnectionPool &) = delete;
+
+    ConnectionHandle open(int fd);               // 接管新连接并注册到reactor
+    TcpConnection *get(ConnectionHandle handle); // 句柄已失效时返回nullptr
+
+    size_t in_use() const { return in_use_.load(std::memory_order_relaxed); } // 可在其他线程读取
+    size_t capacity() const { return slabs_.size() * kSlabSlots; }
+
+private:
+    static constexpr uint32_t kSlabSlots = 64;
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    // 槽位本身即epoll事件处理器，处理期间持有连接引用
+    struct Slot : public EventHandler
+    {
+        Slot(EpollReactor &reactor, const std::string &root_dir);
+        void handle_event(uint32_t events) override;
+
+        TcpConnection tcp;
+        HTTPConnection http;
+        uint32_t generation = 0;
+        uint32_t next_free = 0;
+        bool in_use = false;
+    };
+
+    struct Slab
+    {
+        alignas(Slot) unsigned char storage[sizeof(Slot) * kSlabSlots];
+    };
+
+    Slot &slot(uint32_t index);
+    uint32_t allocate_slot();     // 取空闲槽位，必要时新增一个slab
+    void recycle(uint32_t index); // 引用计数归零后回收槽位
+
+    EpollReactor &reactor_;
+    const std::string root_dir_;
+
+    std::vector<std::unique_ptr<Slab>> slabs_;
+    uint32_t constructed_ = 0; // 已构造的槽位数（槽位首次使用时才构造）
+    uint32_t free_head_ = kNoSlot;
+    std::atomic<size_t> in_use_{0};
+};
+
+#endif
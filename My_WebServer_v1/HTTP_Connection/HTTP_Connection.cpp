@@ -1,96 +1,134 @@
 #include "HTTP_Connection.h"
 #include "../Logger/Logger.h"
-#include <sstream>
 #include <fstream>
 #include <algorithm>
 #include <filesystem>
-#include <set>
 
 HTTPConnection::HTTPConnection(TcpConnection &conn, std::string root_dir)
     : conn_(conn), root_dir_(std::move(root_dir)) {}
 
-void HTTPConnection::handle_input(std::string &input_buffer)
+void HTTPConnection::reset()
 {
-    Logger::get_instance().log(Logger::INFO,
-                               "Worker " + std::to_string(getpid()) +
-                                   " handling fd=" + std::to_string(conn_.fd()));
+    parser_.reset();
+    method_ = uri_ = std::string_view();
+    keep_alive_ = false;
+}
 
-    size_t header_end = input_buffer.find("\r\n\r\n");
-    if (header_end == std::string::npos) // 检查头部信息是否完整
-    {
-        Logger::get_instance().log(Logger::WARNING,
-                                   "Incomplete request headers from fd=" + std::to_string(conn_.fd()));
-        return;
-    }
+void HTTPConnection::handle_input(std::string &input_buffer)
+{
+    LOG_TRACE("Worker " + std::to_string(getpid()) +
+              " handling fd=" + std::to_string(conn_.fd()));
 
-    if (!parse_request(input_buffer.substr(0, header_end + 4)))
+    // 依次处理缓冲区中所有完整的请求（流水线），响应按请求顺序进入发送队列
+    size_t consumed = 0;
+    while (consumed < input_buffer.size())
     {
-        Logger::get_instance().log(Logger::ERROR,
-                                   "Parse failed: " + input_buffer.substr(0, std::min(100ul, input_buffer.size())));
-        send_response(HTTP_BAD_REQUEST, "<h1>400 Bad Request</h1>");
-        // conn_.handle_close();    //潜在错误根源（核心转储）
-        return;
+        size_t request_length = handle_request(input_buffer.data() + consumed, input_buffer.size() - consumed);
+        if (request_length == 0)
+        {
+            break; // 请求不完整，保留到下次读取
+        }
+        consumed += request_length;
+
+        bool keep_alive = keep_alive_;
+        reset();
+        if (!keep_alive)
+        {
+            consumed = input_buffer.size(); // 连接将在响应发完后关闭，后续数据丢弃
+            break;
+        }
     }
 
-    input_buffer.erase(0, header_end + 4);
-    prepare_response();
+    // 视图指向输入缓冲区，全部请求处理完毕后才能移除已处理的数据
+    input_buffer.erase(0, consumed);
 }
 
-bool HTTPConnection::parse_request(const std::string &headers)
+size_t HTTPConnection::handle_request(const char *data, size_t len)
 {
-    std::istringstream iss(headers);
-    std::string line;
-
-    if (!std::getline(iss, line) || line.back() != '\r')
-        return false;
-    line.pop_back();
-
-    std::istringstream req_line(line);
-    if (!(req_line >> method_ >> uri_ >> version_))
-        return false;
-
-    // std::cout << "method: " << method_ << std::endl;
-    // std::cout << "uri: " << uri_ << std::endl;
+    // 解析器记录了上次的进度，只扫描新收到的数据
+    HTTPRequestParser::Result result = parser_.parse(data, len);
+    if (result == HTTPRequestParser::INCOMPLETE) // 检查头部信息是否完整
+    {
+        LOG_DEBUG("Incomplete request headers from fd=" + std::to_string(conn_.fd()));
+        return 0;
+    }
 
-    std::transform(method_.begin(), method_.end(), method_.begin(), ::toupper);
+    request_start_ = std::chrono::steady_clock::now();
+    method_ = parser_.method();
+    uri_ = parser_.uri();
 
-    while (std::getline(iss, line) && line != "\r")
+    if (result == HTTPRequestParser::ERROR)
     {
-        line.pop_back();
-        size_t colon = line.find(':');
-        if (colon == std::string::npos)
-            continue;
-
-        std::string key = line.substr(0, colon);
-        std::string value = line.substr(colon + 1);
-        value.erase(0, value.find_first_not_of(' '));
-        headers_[key] = value;
+        LOG_ERROR("Parse failed: " + std::string(data, std::min(100ul, len)));
+        int status = parser_.error_status();
+        if (status == HTTP_HEADERS_TOO_LARGE)
+            send_response(status, "<h1>431 Request Header Fields Too Large</h1>");
+        else if (status == HTTP_VERSION_NOT_SUPPORTED)
+            send_response(status, "<h1>505 HTTP Version Not Supported</h1>");
+        else
+            send_response(HTTP_BAD_REQUEST, "<h1>400 Bad Request</h1>");
+        return len;
     }
 
-    keep_alive_ = (version_ == "HTTP/1.1");
-    if (headers_.count("Connection"))
+    // 请求体暂不处理，但须整体跳过才能定位下一个请求
+    size_t body_length = 0;
+    if (parser_.has_header("Transfer-Encoding"))
+    {
+        send_response(HTTP_NOT_IMPLEMENTED, "<h1>501 Not Implemented</h1>");
+        return len;
+    }
+    if (parser_.has_header("Content-Length") && !parse_content_length(parser_.header("Content-Length"), body_length))
+    {
+        send_response(HTTP_BAD_REQUEST, "<h1>400 Bad Request</h1>");
+        return len;
+    }
+    size_t request_length = parser_.head_length() + body_length;
+    if (len < request_length)
     {
-        keep_alive_ = (headers_["Connection"] == "keep-alive");
+        return 0; // 等待请求体收齐，解析器保持完成状态
     }
 
+    // HTTP/1.1默认长连接，HTTP/1.0默认短连接，Connection头部可覆盖
+    std::string_view connection = parser_.header("Connection");
+    keep_alive_ = parser_.version_minor() >= 1;
+    if (http_iequals(connection, "close"))
+        keep_alive_ = false;
+    else if (http_iequals(connection, "keep-alive"))
+        keep_alive_ = true;
+
     conn_.set_keep_alive(keep_alive_);
+    prepare_response();
+    return request_length;
+}
+
+bool HTTPConnection::parse_content_length(std::string_view value, size_t &length)
+{
+    if (value.empty() || value.size() > 18)
+    {
+        return false;
+    }
+    length = 0;
+    for (char c : value)
+    {
+        if (c < '0' || c > '9')
+            return false;
+        length = length * 10 + (c - '0');
+    }
     return true;
 }
 
 void HTTPConnection::prepare_response()
 {
-    Logger::get_instance().log(Logger::INFO,
-                               method_ + " " + uri_ + " (fd=" + std::to_string(conn_.fd()) + ")");
+    LOG_DEBUG(std::string(method_) + " " + std::string(uri_) + " (fd=" + std::to_string(conn_.fd()) + ")");
 
-    if (uri_.find("..") != std::string::npos) // 防止路径遍历攻击
+    if (uri_.find("..") != std::string_view::npos) // 防止路径遍历攻击
     {
-        Logger::get_instance().log(Logger::WARNING, "Forbidden path: " + uri_);
+        LOG_WARNING("Forbidden path: " + std::string(uri_));
         send_response(HTTP_FORBIDDEN, "<h1>403 Forbidden</h1>");
         return;
     }
 
-    static const std::set<std::string> allowed_methods = {"GET", "HEAD", "POST"};
-    if (allowed_methods.find(method_) == allowed_methods.end())
+    if (method_ != "GET" && method_ != "HEAD" && method_ != "POST")
     {
         send_response(HTTP_METHOD_NOT_ALLOWED, "<h1>405 Method Not Allowed</h1>");
         return;
@@ -118,7 +156,7 @@ void HTTPConnection::prepare_response()
 // GET方法实现
 void HTTPConnection::handle_get()
 {
-    std::filesystem::path uri_path = (uri_ == "/") ? "/index.html" : uri_;
+    std::filesystem::path uri_path = (uri_ == "/") ? std::string_view("/index.html") : uri_;
     std::filesystem::path full_path = std::filesystem::weakly_canonical(root_dir_ / uri_path.relative_path());
 
     std::string content;
@@ -137,7 +175,7 @@ void HTTPConnection::handle_get()
 
     // std::cout << "handle_get keep_alive_:" << keep_alive_ << std::endl;
 
-    conn_.send(headers + content);
+    respond(HTTP_OK, headers + content);
 }
 
 // HEAD方法实现
@@ -145,7 +183,7 @@ void HTTPConnection::handle_head()
 {
     // std::cout << "handle_head started:" << std::endl;
 
-    std::filesystem::path uri_path = (uri_ == "/") ? "/index.html" : uri_;
+    std::filesystem::path uri_path = (uri_ == "/") ? std::string_view("/index.html") : uri_;
     std::filesystem::path full_path = std::filesystem::weakly_canonical(root_dir_ / uri_path.relative_path());
 
     std::string content;
@@ -159,7 +197,7 @@ void HTTPConnection::handle_head()
 
     // std::cout << "handle_head keep_alive_:" << keep_alive_ << std::endl;
 
-    conn_.send(headers); // 仅发送头部
+    respond(file_ok ? HTTP_OK : HTTP_NOT_FOUND, headers); // 仅发送头部
 }
 
 // POST方法实现
@@ -172,12 +210,12 @@ void HTTPConnection::handle_post()
     headers += "Connection: " + std::string(keep_alive_ ? "keep-alive" : "close") + "\r\n\r\n";
 
     // std::cout << "handle_post keep_alive_:" << keep_alive_ << std::endl;
-    conn_.send(headers + response_body);
+    respond(HTTP_OK, headers + response_body);
 }
 
 void HTTPConnection::send_response(int status, const std::string &content)
 {
-    Logger::get_instance().log(Logger::INFO, "Response " + std::to_string(status) + " for " + uri_);
+    LOG_DEBUG("Response " + std::to_string(status) + " for " + std::string(uri_));
 
     std::map<int, std::string> status_text = {
         {HTTP_OK, "OK"},
@@ -185,8 +223,10 @@ void HTTPConnection::send_response(int status, const std::string &content)
         {HTTP_FORBIDDEN, "Forbidden"},
         {HTTP_NOT_FOUND, "Not Found"},
         {HTTP_METHOD_NOT_ALLOWED, "Method Not Allowed"},
+        {HTTP_HEADERS_TOO_LARGE, "Request Header Fields Too Large"},
         {HTTP_INTERNAL_ERROR, "Internal Server Error"},
-        {HTTP_NOT_IMPLEMENTED, "Not Implemented"}};
+        {HTTP_NOT_IMPLEMENTED, "Not Implemented"},
+        {HTTP_VERSION_NOT_SUPPORTED, "HTTP Version Not Supported"}};
 
     std::string headers = "HTTP/1.1 " +
                           std::to_string(status) + " " +
@@ -194,12 +234,37 @@ void HTTPConnection::send_response(int status, const std::string &content)
 
     headers += "Content-Type: text/html\r\n";
     headers += "Content-Length: " + std::to_string(content.size()) + "\r\n";
-    headers += "Connection: close\r\n\r\n";
-
-    keep_alive_ = false;
+    // 解析失败时keep_alive_尚未置位，连接关闭；403/404等请求本身完整，可继续处理后续请求
+    headers += "Connection: " + std::string(keep_alive_ ? "keep-alive" : "close") + "\r\n\r\n";
 
     conn_.set_keep_alive(keep_alive_);
-    conn_.send(headers + content);
+    respond(status, headers + content);
+}
+
+void HTTPConnection::respond(int status, std::string response)
+{
+    size_t bytes_sent = response.size();
+    conn_.send(std::move(response));
+
+    Logger &logger = Logger::get_instance();
+    if (!logger.access_log_enabled())
+    {
+        return;
+    }
+
+    AccessRecord record{};
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+    record.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - request_start_)
+                            .count();
+    record.bytes_sent = bytes_sent;
+    record.pid = getpid();
+    record.fd = conn_.fd();
+    record.status = static_cast<uint16_t>(status);
+    record.method = access_method_from(method_);
+    logger.log_access(record, uri_);
 }
 
 bool HTTPConnection::read_file_content(const std::string &path, std::string &content) const
@@ -3,33 +3,40 @@
 
 #pragma once
 #include "../Epoll_Reactor/Epoll_Reactor.h"
+#include "../HTTP_Parser/HTTP_Parser.h"
 #include <string>
 #include <map>
 #include <functional>
+#include <chrono>
 
 class HTTPConnection
 {
 public:
     explicit HTTPConnection(TcpConnection &conn, std::string root_dir);
-    void handle_input(std::string &input_buffer);
+    void handle_input(std::string &input_buffer); // 处理缓冲区中全部完整的请求，移除已处理的数据
+    void reset(); // 连接复用时清空上一个连接的请求状态
 
 private:
+    size_t handle_request(const char *data, size_t len); // 处理一个请求，返回其字节数，不完整时返回0
+    static bool parse_content_length(std::string_view value, size_t &length);
+
     void handle_get();  // 处理GET请求
     void handle_head(); // 处理HEAD请求
     void handle_post(); // 处理POST请求
 
-    bool parse_request(const std::string &buffer);              // 解析请求
     void prepare_response();                                    // 准备响应
     void send_response(int status, const std::string &content); // 错误处理
+    void respond(int status, std::string response);             // 发送响应并记录访问日志
     std::string get_mime_type(const std::string &path) const;
     bool read_file_content(const std::string &path, std::string &content) const; // 读取文件内容
 
     TcpConnection &conn_; // TCP连接
 
-    std::string method_;                         // 请求方法
-    std::string uri_;                            // 请求URI
-    std::string version_;                        // HTTP版本
-    std::map<std::string, std::string> headers_; // 请求头部集合
+    HTTPRequestParser parser_; // 请求解析器，跨多次读取保存解析进度
+    std::string_view method_;  // 请求方法（指向输入缓冲区，仅在处理当前请求期间有效）
+    std::string_view uri_;     // 请求URI
+
+    std::chrono::steady_clock::time_point request_start_; // 开始处理请求的时刻
 
     bool keep_alive_ = false;    // 长连接标志
     const std::string root_dir_; // 根目录
@@ -39,8 +46,10 @@ private:
     static constexpr int HTTP_FORBIDDEN = 403;
     static constexpr int HTTP_NOT_FOUND = 404;
     static constexpr int HTTP_METHOD_NOT_ALLOWED = 405;
+    static constexpr int HTTP_HEADERS_TOO_LARGE = 431;
     static constexpr int HTTP_INTERNAL_ERROR = 500;
     static constexpr int HTTP_NOT_IMPLEMENTED = 501;
+    static constexpr int HTTP_VERSION_NOT_SUPPORTED = 505;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "Delimiter_Scan.h"
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_HAS_X86 1
+#endif
+
+namespace
+{
+    // RFC 9110 tchar: "!#$%&'*+-.^_`|~" / DIGIT / ALPHA
+    // SIMD实现按高、低4位分别查表：nibble_lo[低4位] & nibble_hi[高4位] 非零即为tchar
+    struct TokenTable
+    {
+        bool tchar[256] = {};
+        uint8_t nibble_lo[16] = {}; // 低4位为i的tchar，其高4位的集合（位图）
+        uint8_t nibble_hi[16] = {}; // 高4位h对应的位，非ASCII为0
+
+        constexpr TokenTable()
+        {
+            for (int c = '0'; c <= '9'; ++c)
+                tchar[c] = true;
+            for (int c = 'a'; c <= 'z'; ++c)
+                tchar[c] = tchar[c - 'a' + 'A'] = true;
+            for (char c : std::string_view("!#$%&'*+-.^_`|~"))
+                tchar[static_cast<unsigned char>(c)] = true;
+
+            for (int c = 0; c < 128; ++c)
+            {
+                if (tchar[c])
+                    nibble_lo[c & 0x0f] |= static_cast<uint8_t>(1 << (c >> 4));
+            }
+            for (int h = 0; h < 8; ++h)
+                nibble_hi[h] = static_cast<uint8_t>(1 << h);
+        }
+    };
+    constexpr TokenTable kTokens;
+
+    // ---------------- 标量实现 ----------------
+
+    const char *scan_token_scalar(const char *p, const char *end)
+    {
+        while (p < end && kTokens.tchar[static_cast<unsigned char>(*p)])
+            ++p;
+        return p;
+    }
+
+    const char *scan_field_value_scalar(const char *p, const char *end)
+    {
+        for (; p < end; ++p)
+        {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if ((c < 0x20 && c != '\t') || c == 0x7f)
+                break;
+        }
+        return p;
+    }
+
+    const char *scan_request_target_scalar(const char *p, const char *end)
+    {
+        for (; p < end; ++p)
+        {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c <= 0x20 || c == 0x7f)
+                break;
+        }
+        return p;
+    }
+
+#ifdef SCAN_HAS_X86
+    // ---------------- SSE4.2：PCMPESTRI按字符区间匹配，每次16字节 ----------------
+
+    // 允许的字符区间，每两个字节为一个闭区间
+    constexpr char kValueRanges[16] = "\t\t ~\x80\xff";
+    constexpr char kTargetRanges[16] = "!~\x80\xff";
+
+    constexpr int kRangeMode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+
+    // tchar有9个区间，超出PCMPESTRI最多8个区间的限制，改用PSHUFB查表
+    __attribute__((target("sse4.2"))) const char *scan_token_sse42(const char *p, const char *end)
+    {
+        const __m128i lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kTokens.nibble_lo));
+        const __m128i hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kTokens.nibble_hi));
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i lo = _mm_shuffle_epi8(lo_table, _mm_and_si128(v, nibble));
+            __m128i hi = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+            __m128i bad = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+            int bits = _mm_movemask_epi8(bad);
+            if (bits != 0)
+                return p + __builtin_ctz(bits);
+        }
+        return scan_token_scalar(p, end);
+    }
+
+    __attribute__((target("sse4.2"))) const char *scan_field_value_sse42(const char *p, const char *end)
+    {
+        const __m128i ranges = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kValueRanges));
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            int index = _mm_cmpestri(ranges, 6, v, 16, kRangeMode);
+            if (index != 16)
+                return p + index;
+        }
+        return scan_field_value_scalar(p, end);
+    }
+
+    __attribute__((target("sse4.2"))) const char *scan_request_target_sse42(const char *p, const char *end)
+    {
+        const __m128i ranges = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kTargetRanges));
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            int index = _mm_cmpestri(ranges, 4, v, 16, kRangeMode);
+            if (index != 16)
+                return p + index;
+        }
+        return scan_request_target_scalar(p, end);
+    }
+
+    // ---------------- AVX2：按字节比较生成掩码，每次32字节 ----------------
+
+    __attribute__((target("avx2"))) const char *scan_token_avx2(const char *p, const char *end)
+    {
+        const __m256i lo_table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(kTokens.nibble_lo)));
+        const __m256i hi_table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(kTokens.nibble_hi)));
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i lo = _mm256_shuffle_epi8(lo_table, _mm256_and_si256(v, nibble));
+            __m256i hi = _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+            __m256i bad = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+            unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+            if (bits != 0)
+                return p + __builtin_ctz(bits);
+        }
+        return scan_token_scalar(p, end);
+    }
+
+    // 字节按有符号数比较：0x00~0x1F为控制字符，0x80以上为负数（obs-text，允许）
+    __attribute__((target("avx2"))) const char *scan_field_value_avx2(const char *p, const char *end)
+    {
+        const __m256i space = _mm256_set1_epi8(0x20);
+        const __m256i minus_one = _mm256_set1_epi8(-1);
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i del = _mm256_set1_epi8(0x7f);
+
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i ctl = _mm256_and_si256(_mm256_cmpgt_epi8(space, v), _mm256_cmpgt_epi8(v, minus_one));
+            __m256i bad = _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab), ctl),
+                                          _mm256_cmpeq_epi8(v, del));
+            unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+            if (bits != 0)
+                return p + __builtin_ctz(bits);
+        }
+        return scan_field_value_scalar(p, end);
+    }
+
+    __attribute__((target("avx2"))) const char *scan_request_target_avx2(const char *p, const char *end)
+    {
+        const __m256i bang = _mm256_set1_epi8(0x21);
+        const __m256i minus_one = _mm256_set1_epi8(-1);
+        const __m256i del = _mm256_set1_epi8(0x7f);
+
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i bad = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi8(bang, v), _mm256_cmpgt_epi8(v, minus_one)),
+                                          _mm256_cmpeq_epi8(v, del));
+            unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+            if (bits != 0)
+                return p + __builtin_ctz(bits);
+        }
+        return scan_request_target_scalar(p, end);
+    }
+#endif
+
+    // ---------------- 运行时分发 ----------------
+
+    struct ScanOps
+    {
+        ScanKernel kernel;
+        const char *(*token)(const char *, const char *);
+        const char *(*field_value)(const char *, const char *);
+        const char *(*request_target)(const char *, const char *);
+    };
+
+    constexpr ScanOps kScalarOps{ScanKernel::SCALAR, scan_token_scalar, scan_field_value_scalar, scan_request_target_scalar};
+#ifdef SCAN_HAS_X86
+    constexpr ScanOps kSse42Ops{ScanKernel::SSE42, scan_token_sse42, scan_field_value_sse42, scan_request_target_sse42};
+    constexpr ScanOps kAvx2Ops{ScanKernel::AVX2, scan_token_avx2, scan_field_value_avx2, scan_request_target_avx2};
+#endif
+
+    const ScanOps *ops_for(ScanKernel kernel)
+    {
+#ifdef SCAN_HAS_X86
+        __builtin_cpu_init(); // 可能在其他全局对象的构造函数中被调用
+        if (kernel == ScanKernel::AVX2 && __builtin_cpu_supports("avx2"))
+            return &kAvx2Ops;
+        if (kernel == ScanKernel::SSE42 && __builtin_cpu_supports("sse4.2"))
+            return &kSse42Ops;
+#endif
+        return kernel == ScanKernel::SCALAR ? &kScalarOps : nullptr;
+    }
+
+    const ScanOps *detect_ops()
+    {
+        for (ScanKernel kernel : {ScanKernel::AVX2, ScanKernel::SSE42})
+        {
+            if (const ScanOps *ops = ops_for(kernel))
+                return ops;
+        }
+        return &kScalarOps;
+    }
+
+    const ScanOps *g_scan_ops = detect_ops();
+}
+
+const char *scan_token(const char *p, const char *end)
+{
+    return g_scan_ops->token(p, end);
+}
+
+const char *scan_field_value(const char *p, const char *end)
+{
+    return g_scan_ops->field_value(p, end);
+}
+
+const char *scan_request_target(const char *p, const char *end)
+{
+    return g_scan_ops->request_target(p, end);
+}
+
+ScanKernel active_scan_kernel()
+{
+    return g_scan_ops->kernel;
+}
+
+const char *scan_kernel_name(ScanKernel kernel)
+{
+    switch (kernel)
+    {
+    case ScanKernel::AVX2:
+        return "avx2";
+    case ScanKernel::SSE42:
+        return "sse4.2";
+    default:
+        return "scalar";
+    }
+}
+
+bool select_scan_kernel(ScanKernel kernel)
+{
+    const ScanOps *ops = ops_for(kernel);
+    if (ops == nullptr)
+        return false;
+    g_scan_ops = ops;
+    return true;
+}
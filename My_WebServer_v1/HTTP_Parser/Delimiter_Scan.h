@@ -0,0 +1,25 @@
+#ifndef DELIMITER_SCAN_H
+#define DELIMITER_SCAN_H
+
+// 请求头分隔符扫描：每个函数在查找分隔符的同时校验经过的字符，一遍完成切分与合法性检查
+// 启动时通过CPUID选择AVX2/SSE4.2实现，不支持时使用逐字节的标量实现
+
+enum class ScanKernel
+{
+    SCALAR,
+    SSE42,
+    AVX2
+};
+
+// 返回[p, end)中第一个不属于RFC 9110 tchar的字节，全部属于时返回end
+const char *scan_token(const char *p, const char *end);
+// 第一个不能出现在字段值中的字节（CR、LF及除HTAB外的控制字符、DEL）
+const char *scan_field_value(const char *p, const char *end);
+// 第一个不能出现在请求目标中的字节（空白、控制字符、DEL）
+const char *scan_request_target(const char *p, const char *end);
+
+ScanKernel active_scan_kernel();
+const char *scan_kernel_name(ScanKernel kernel);
+bool select_scan_kernel(ScanKernel kernel); // CPU不支持时返回false且不切换，供基准测试对比
+
+#endif
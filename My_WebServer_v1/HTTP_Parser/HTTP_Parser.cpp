@@ -0,0 +1,233 @@
+#include "HTTP_Parser.h"
+#include "Delimiter_Scan.h"
+#include <cstring>
+
+bool http_iequals(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        unsigned char x = static_cast<unsigned char>(a[i]);
+        unsigned char y = static_cast<unsigned char>(b[i]);
+        if (x == y)
+            continue;
+        unsigned char lower = x | 0x20;
+        if (lower != (y | 0x20) || lower < 'a' || lower > 'z')
+            return false;
+    }
+    return true;
+}
+
+void HTTPRequestParser::reset()
+{
+    base_ = nullptr;
+    state_ = REQUEST_LINE;
+    pos_ = scan_pos_ = 0;
+    method_ = uri_ = version_ = Span{};
+    version_minor_ = 0;
+    header_count_ = 0;
+    error_status_ = 0;
+}
+
+HTTPRequestParser::Result HTTPRequestParser::fail(int status)
+{
+    state_ = FAILED;
+    error_status_ = status;
+    return ERROR;
+}
+
+HTTPRequestParser::Result HTTPRequestParser::parse(const char *data, size_t len)
+{
+    base_ = data;
+    if (state_ == DONE)
+        return COMPLETE;
+    if (state_ == FAILED)
+        return ERROR;
+
+    const char *end = data + len;
+
+    // 请求行较短，先找到行尾再整体切分
+    while (state_ == REQUEST_LINE)
+    {
+        const char *newline = scan_pos_ < len
+                                  ? static_cast<const char *>(std::memchr(data + scan_pos_, '\n', len - scan_pos_))
+                                  : nullptr;
+        if (newline == nullptr)
+        {
+            scan_pos_ = len;
+            return need_more(len);
+        }
+
+        size_t eol = newline - data;
+        if (eol >= kMaxHeadBytes)
+        {
+            return fail(431);
+        }
+
+        // 行尾为CRLF，兼容单独的LF；请求行之前的空行忽略（RFC 9112 2.2）
+        size_t line_end = (eol > pos_ && data[eol - 1] == '\r') ? eol - 1 : eol;
+        if (line_end > pos_)
+        {
+            if (!parse_request_line(pos_, line_end))
+                return ERROR;
+            state_ = HEADER_NAME;
+        }
+        pos_ = scan_pos_ = eol + 1;
+    }
+
+    // 头部字段：字段名和字段值各扫描一遍，切分的同时完成字符校验
+    while (true)
+    {
+        if (state_ == HEADER_NAME)
+        {
+            if (pos_ == len)
+                return need_more(len);
+
+            char first = data[pos_];
+            if (first == '\r' || first == '\n')
+            {
+                // 空行，请求头结束
+                size_t eol = pos_;
+                if (first == '\r')
+                {
+                    if (pos_ + 1 == len)
+                        return need_more(len);
+                    if (data[pos_ + 1] != '\n')
+                        return fail(400);
+                    eol++;
+                }
+                if (eol >= kMaxHeadBytes)
+                    return fail(431);
+                pos_ = scan_pos_ = eol + 1;
+                state_ = DONE;
+                return COMPLETE;
+            }
+
+            // 不支持已废弃的多行折叠（obs-fold）
+            if (first == ' ' || first == '\t')
+                return fail(400);
+
+            // 字段名与冒号之间不允许有空白，字段名须为token
+            const char *colon = scan_token(data + scan_pos_, end);
+            if (colon == end)
+            {
+                scan_pos_ = len;
+                return need_more(len);
+            }
+            if (*colon != ':' || colon == data + pos_)
+                return fail(400);
+            if (header_count_ == kMaxHeaders)
+                return fail(431);
+
+            headers_[header_count_].name = span(pos_, colon - data);
+            scan_pos_ = colon - data + 1;
+            state_ = HEADER_VALUE;
+        }
+
+        // 字段值扫描在第一个CR、LF或非法字符处停下
+        const char *stop = scan_field_value(data + scan_pos_, end);
+        if (stop == end)
+        {
+            scan_pos_ = len;
+            return need_more(len);
+        }
+
+        size_t value_end = stop - data;
+        size_t eol = value_end;
+        if (*stop == '\r')
+        {
+            if (value_end + 1 == len)
+            {
+                scan_pos_ = value_end;
+                return need_more(len);
+            }
+            if (data[value_end + 1] != '\n')
+                return fail(400);
+            eol++;
+        }
+        else if (*stop != '\n')
+        {
+            return fail(400);
+        }
+        if (eol >= kMaxHeadBytes)
+            return fail(431);
+
+        Span name = headers_[header_count_].name;
+        size_t value_begin = name.offset + name.length + 1;
+        while (value_begin < value_end && (data[value_begin] == ' ' || data[value_begin] == '\t'))
+            value_begin++;
+        while (value_end > value_begin && (data[value_end - 1] == ' ' || data[value_end - 1] == '\t'))
+            value_end--;
+
+        headers_[header_count_].value = span(value_begin, value_end);
+        header_count_++;
+        pos_ = scan_pos_ = eol + 1;
+        state_ = HEADER_NAME;
+    }
+}
+
+bool HTTPRequestParser::parse_request_line(size_t begin, size_t end)
+{
+    const char *line = base_ + begin;
+    const char *line_end = base_ + end;
+
+    // method SP request-target SP HTTP-version
+    const char *sp1 = scan_token(line, line_end);
+    if (sp1 == line || sp1 == line_end || *sp1 != ' ')
+    {
+        fail(400);
+        return false;
+    }
+
+    const char *target = sp1 + 1;
+    const char *sp2 = scan_request_target(target, line_end);
+    if (sp2 == target || sp2 == line_end || *sp2 != ' ')
+    {
+        fail(400);
+        return false;
+    }
+
+    std::string_view version(sp2 + 1, line_end - sp2 - 1);
+    if (version.size() != 8 || version.compare(0, 5, "HTTP/") != 0 || version[6] != '.' ||
+        version[5] < '0' || version[5] > '9' || version[7] < '0' || version[7] > '9')
+    {
+        fail(400);
+        return false;
+    }
+    if (version[5] != '1')
+    {
+        fail(505);
+        return false;
+    }
+
+    method_ = span(begin, begin + (sp1 - line));
+    uri_ = span(begin + (target - line), begin + (sp2 - line));
+    version_ = span(begin + (sp2 + 1 - line), end);
+    version_minor_ = version[7] - '0';
+    return true;
+}
+
+std::string_view HTTPRequestParser::header(std::string_view name) const
+{
+    for (size_t i = 0; i < header_count_; ++i)
+    {
+        if (http_iequals(view(headers_[i].name), name))
+        {
+            return view(headers_[i].value);
+        }
+    }
+    return {};
+}
+
+bool HTTPRequestParser::has_header(std::string_view name) const
+{
+    for (size_t i = 0; i < header_count_; ++i)
+    {
+        if (http_iequals(view(headers_[i].name), name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
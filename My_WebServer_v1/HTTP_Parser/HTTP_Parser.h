@@ -0,0 +1,89 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+bool http_iequals(std::string_view a, std::string_view b); // ASCII不区分大小写比较
+
+// 可续传的HTTP/1.1请求头解析器
+// 直接在连接的输入缓冲区上解析，只记录各字段的偏移和长度，不复制数据；
+// 请求头不完整时保存解析进度，收到更多数据后从上次停下的位置继续。
+// 头部字段用Delimiter_Scan中的SIMD扫描函数切分，查找冒号、行尾的同时校验字符
+class HTTPRequestParser
+{
+public:
+    enum Result
+    {
+        COMPLETE,   // 请求头已完整解析
+        INCOMPLETE, // 需要更多数据
+        ERROR       // 请求非法，error_status()给出应答状态码
+    };
+
+    static constexpr size_t kMaxHeaders = 64;          // 最多头部字段数
+    static constexpr size_t kMaxHeadBytes = 64 * 1024; // 请求行+头部的最大字节数
+
+    // data为缓冲区起始位置，每次调用时缓冲区已有内容必须不变（可以追加或整体搬移）
+    Result parse(const char *data, size_t len);
+    void reset(); // 开始解析下一个请求
+
+    // 以下视图指向最近一次parse()传入的缓冲区，缓冲区改动后失效
+    std::string_view method() const { return view(method_); }
+    std::string_view uri() const { return view(uri_); }
+    std::string_view version() const { return view(version_); }
+    int version_minor() const { return version_minor_; } // HTTP/1.x中的x
+
+    size_t header_count() const { return header_count_; }
+    std::string_view header_name(size_t i) const { return view(headers_[i].name); }
+    std::string_view header_value(size_t i) const { return view(headers_[i].value); }
+    std::string_view header(std::string_view name) const; // 名称不区分大小写，不存在时返回空视图
+    bool has_header(std::string_view name) const;
+
+    size_t head_length() const { return pos_; } // 解析完成后为请求头（含空行）的字节数
+    int error_status() const { return error_status_; }
+
+private:
+    struct Span
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    struct Header
+    {
+        Span name;
+        Span value;
+    };
+
+    enum State
+    {
+        REQUEST_LINE,
+        HEADER_NAME,  // 在字段名中，查找冒号
+        HEADER_VALUE, // 在字段值中，查找行尾
+        DONE,
+        FAILED
+    };
+
+    bool parse_request_line(size_t begin, size_t end); // [begin, end)为去掉行尾的一行
+    Result fail(int status);
+    Result need_more(size_t len) { return len > kMaxHeadBytes ? fail(431) : INCOMPLETE; }
+
+    std::string_view view(Span span) const { return {base_ + span.offset, span.length}; }
+    static Span span(size_t begin, size_t end) { return {static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)}; }
+
+    const char *base_ = nullptr;
+    State state_ = REQUEST_LINE;
+    size_t pos_ = 0;      // 当前行的起始位置
+    size_t scan_pos_ = 0; // 续扫位置，避免重复扫描已收到的数据
+
+    Span method_;
+    Span uri_;
+    Span version_;
+    int version_minor_ = 0;
+    Header headers_[kMaxHeaders];
+    size_t header_count_ = 0;
+    int error_status_ = 0;
+};
+
+#endif
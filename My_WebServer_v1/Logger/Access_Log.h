@@ -0,0 +1,79 @@
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// 二进制访问日志格式（服务器与logdump工具共用）
+// 文件 = AccessLogHeader + 若干条记录；每条记录 = AccessRecord + URI字节
+
+enum AccessMethod : uint8_t
+{
+    ACCESS_UNKNOWN = 0,
+    ACCESS_GET,
+    ACCESS_HEAD,
+    ACCESS_POST,
+    ACCESS_PUT,
+    ACCESS_DELETE,
+    ACCESS_OPTIONS,
+    ACCESS_PATCH
+};
+
+#pragma pack(push, 1)
+struct AccessLogHeader
+{
+    char magic[8];          // "WSACCLOG"
+    uint16_t version;       // 格式版本
+    uint16_t record_size;   // sizeof(AccessRecord)，便于以后扩展字段
+    uint32_t reserved;
+};
+
+struct AccessRecord
+{
+    uint64_t timestamp_ns;  // 请求完成时刻（CLOCK_REALTIME）
+    uint64_t latency_ns;    // 从开始处理请求到响应入队的耗时
+    uint64_t bytes_sent;    // 响应字节数（头部+主体）
+    uint32_t pid;           // worker进程号
+    int32_t fd;             // 连接fd
+    uint16_t status;        // HTTP状态码
+    uint8_t method;         // AccessMethod
+    uint8_t reserved;
+    uint16_t uri_offset;    // URI相对记录起始的偏移
+    uint16_t uri_length;    // URI长度
+};
+#pragma pack(pop)
+
+constexpr char kAccessLogMagic[8] = {'W', 'S', 'A', 'C', 'C', 'L', 'O', 'G'};
+constexpr uint16_t kAccessLogVersion = 1;
+
+inline AccessMethod access_method_from(std::string_view method)
+{
+    static const char *const names[] = {"GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "PATCH"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    {
+        if (method == names[i])
+        {
+            return static_cast<AccessMethod>(i + 1);
+        }
+    }
+    return ACCESS_UNKNOWN;
+}
+
+inline const char *access_method_name(uint8_t method)
+{
+    static const char *const names[] = {"UNKNOWN", "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "PATCH"};
+    return method < sizeof(names) / sizeof(names[0]) ? names[method] : "UNKNOWN";
+}
+
+inline AccessLogHeader make_access_log_header()
+{
+    AccessLogHeader header{};
+    std::memcpy(header.magic, kAccessLogMagic, sizeof(header.magic));
+    header.version = kAccessLogVersion;
+    header.record_size = sizeof(AccessRecord);
+    return header;
+}
+
+#endif
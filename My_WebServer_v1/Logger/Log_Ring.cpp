@@ -0,0 +1,68 @@
+#include "Log_Ring.h"
+#include <algorithm>
+#include <cstring>
+
+LogRing::LogRing(size_t capacity)
+{
+    size_t size = 64;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    buffer_.resize(size);
+    mask_ = size - 1;
+}
+
+bool LogRing::push(const char *data, uint32_t len)
+{
+    const size_t frame = sizeof(uint32_t) + len;
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+
+    if (frame > buffer_.size() - (head - tail))
+    {
+        return false; // 剩余空间不足
+    }
+
+    copy_in(head, &len, sizeof(len));
+    copy_in(head + sizeof(len), data, len);
+    head_.store(head + frame, std::memory_order_release); // 发布整帧
+    return true;
+}
+
+bool LogRing::pop(std::string &out)
+{
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    uint32_t len = 0;
+    copy_out(tail, &len, sizeof(len));
+
+    const size_t old_size = out.size();
+    out.resize(old_size + len);
+    copy_out(tail + sizeof(len), &out[old_size], len);
+
+    tail_.store(tail + sizeof(len) + len, std::memory_order_release); // 归还空间
+    return true;
+}
+
+void LogRing::copy_in(size_t pos, const void *src, size_t len)
+{
+    size_t offset = pos & mask_;
+    size_t first = std::min(len, buffer_.size() - offset); // 回绕前可写的长度
+    std::memcpy(&buffer_[offset], src, first);
+    std::memcpy(&buffer_[0], static_cast<const char *>(src) + first, len - first);
+}
+
+void LogRing::copy_out(size_t pos, void *dst, size_t len) const
+{
+    size_t offset = pos & mask_;
+    size_t first = std::min(len, buffer_.size() - offset);
+    std::memcpy(dst, &buffer_[offset], first);
+    std::memcpy(static_cast<char *>(dst) + first, &buffer_[0], len - first);
+}
@@ -0,0 +1,40 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 单生产者单消费者的无锁环形缓冲区
+// 每条日志按帧存储：4字节长度 + 日志内容，生产者为写日志的线程，消费者为后台写线程
+class LogRing
+{
+public:
+    explicit LogRing(size_t capacity); // 容量向上取整为2的幂
+
+    LogRing(const LogRing &) = delete;
+    LogRing &operator=(const LogRing &) = delete;
+
+    bool push(const char *data, uint32_t len); // 生产者：写入一帧，空间不足返回false
+    bool pop(std::string &out);                // 消费者：取出一帧并追加到out，为空返回false
+
+    size_t capacity() const { return buffer_.size(); }
+    size_t used() const // 已占用字节数（近似值）
+    {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void copy_in(size_t pos, const void *src, size_t len);
+    void copy_out(size_t pos, void *dst, size_t len) const;
+
+    std::vector<char> buffer_;
+    size_t mask_;
+
+    alignas(64) std::atomic<size_t> head_{0}; // 生产者写入位置（单调递增）
+    alignas(64) std::atomic<size_t> tail_{0}; // 消费者读取位置（单调递增）
+};
+
+#endif
@@ -2,6 +2,116 @@
 #include <iomanip>
 #include <stdexcept>
 #include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <tuple>
+#include <csignal>
+#include <zlib.h>
+
+namespace
+{
+    constexpr size_t kMaxBatchBytes = 256 * 1024; // 后台线程单次write的最大字节数
+
+    thread_local LogRing *t_ring = nullptr;        // 当前线程的环形缓冲区
+    thread_local LogRing *t_access_ring = nullptr; // 当前线程的访问日志缓冲区
+
+    // 每个线程缓存当前秒的格式化结果，秒数变化时才调用localtime_r/strftime
+    struct TimeCache
+    {
+        time_t second = -1;
+        char datetime[24]; // "YYYY-MM-DD HH:MM:SS"
+        size_t len = 0;
+    };
+
+    thread_local TimeCache t_time;
+
+    const TimeCache &cached_time(timespec &now)
+    {
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (now.tv_sec != t_time.second)
+        {
+            tm local_time;
+            localtime_r(&now.tv_sec, &local_time);
+            t_time.len = strftime(t_time.datetime, sizeof(t_time.datetime), "%Y-%m-%d %H:%M:%S", &local_time);
+            t_time.second = now.tv_sec;
+        }
+        return t_time;
+    }
+
+    // 追加固定位数的十进制数（不足补0）
+    void append_digits(std::string &out, long value, int width)
+    {
+        char digits[8];
+        for (int i = width - 1; i >= 0; --i)
+        {
+            digits[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        out.append(digits, width);
+    }
+
+    // 解析日志文件名 "YYYY-MM-DD[_N].log[.gz]"，成功返回true
+    bool parse_log_name(const std::string &name, std::string &date, int &index)
+    {
+        if (name.size() < 14 || name[4] != '-' || name[7] != '-')
+            return false;
+
+        size_t pos = 10;
+        index = 0;
+        if (name[pos] == '_')
+        {
+            size_t end = name.find('.', pos);
+            if (end == std::string::npos || end == pos + 1)
+                return false;
+            for (size_t i = pos + 1; i < end; ++i)
+            {
+                if (name[i] < '0' || name[i] > '9')
+                    return false;
+                index = index * 10 + (name[i] - '0');
+            }
+            pos = end;
+        }
+
+        std::string suffix = name.substr(pos);
+        if (suffix != ".log" && suffix != ".log.gz")
+            return false;
+
+        date = name.substr(0, 10);
+        return true;
+    }
+
+    // 使用zlib将src压缩为dst
+    bool gzip_file(const std::string &src, const std::string &dst)
+    {
+        int in = open(src.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0)
+            return false;
+
+        gzFile out = gzopen(dst.c_str(), "wb6");
+        if (out == nullptr)
+        {
+            close(in);
+            return false;
+        }
+
+        char buffer[64 * 1024];
+        ssize_t n;
+        bool ok = true;
+        while ((n = read(in, buffer, sizeof(buffer))) > 0)
+        {
+            if (gzwrite(out, buffer, static_cast<unsigned>(n)) != n)
+            {
+                ok = false;
+                break;
+            }
+        }
+
+        close(in);
+        return gzclose(out) == Z_OK && ok && n == 0;
+    }
+}
 
 Logger &Logger::get_instance()
 {
@@ -11,18 +121,39 @@ Logger &Logger::get_instance()
 
 Logger::~Logger()
 {
-    if (log_file_.is_open())
+    shutdown();
+
+    // 等待后台压缩线程结束
+    {
+        std::unique_lock<std::mutex> lock(files_mutex_);
+        compress_cv_.wait(lock, [this]
+                          { return pending_compress_ == 0; });
+    }
+
+    if (log_fd_ >= 0)
     {
-        log_file_.close();
+        close(log_fd_);
     }
+    if (access_fd_ >= 0)
+    {
+        close(access_fd_);
+    }
+    SharedLogRing::destroy(shared_ring_);
 }
 
 void Logger::init(const std::string &log_dir, int max_lines)
+{
+    RotationOptions rotation;
+    rotation.max_lines = max_lines;
+    init(log_dir, rotation);
+}
+
+void Logger::init(const std::string &log_dir, const RotationOptions &rotation)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     current_lines_.store(0);
     log_dir_ = log_dir;
-    max_lines_ = max_lines;
+    rotation_ = rotation;
 
     // 创建日志目录
     if (!std::filesystem::exists(log_dir_))
@@ -30,6 +161,8 @@ void Logger::init(const std::string &log_dir, int max_lines)
         std::filesystem::create_directories(log_dir_);
     }
 
+    scan_existing_files();
+
     // try
     // {
     check_file();
@@ -43,14 +176,428 @@ void Logger::init(const std::string &log_dir, int max_lines)
 
 void Logger::log(LogLevel level, const std::string &message)
 {
+    thread_local std::string line; // 复用的格式化缓冲区
+    line.clear();
+
+    format_line(line, level, message);
+
+    if (shared_active_.load(std::memory_order_acquire))
+    {
+        // 超长日志在共享槽位中截断，保留行尾换行
+        if (line.size() > SharedLogRing::kPayloadSize)
+        {
+            line.resize(SharedLogRing::kPayloadSize - 1);
+            line += '\n';
+        }
+        if (push_shared(line, 0))
+        {
+            return;
+        }
+    }
+    else if (async_running_.load(std::memory_order_acquire) && push_async(local_ring(), line))
+    {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!log_file_.is_open())
+    if (log_fd_ < 0)
+        return;
+
+    write_lines(line, 1);
+}
+
+void Logger::log_access(AccessRecord record, std::string_view uri)
+{
+    thread_local std::string frame; // 记录 + URI
+    bool shared = shared_active_.load(std::memory_order_acquire);
+    size_t uri_limit = shared ? SharedLogRing::kPayloadSize - sizeof(AccessRecord) : UINT16_MAX;
+    size_t uri_length = std::min(uri.size(), uri_limit);
+    record.uri_offset = sizeof(AccessRecord);
+    record.uri_length = static_cast<uint16_t>(uri_length);
+
+    frame.assign(reinterpret_cast<const char *>(&record), sizeof(record));
+    frame.append(uri.data(), uri_length);
+
+    if (shared)
+    {
+        if (push_shared(frame, 1))
+        {
+            return;
+        }
+    }
+    else if (async_running_.load(std::memory_order_acquire) && push_async(local_ring(true), frame))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_access(frame);
+}
+
+bool Logger::push_shared(const std::string &frame, uint8_t channel)
+{
+    while (!shared_ring_->push(frame.data(), frame.size(), channel))
+    {
+        if (async_options_.policy == DROP)
+        {
+            shared_ring_->add_dropped();
+            return true;
+        }
+
+        shared_ring_->notify();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+        if (!shared_active_.load(std::memory_order_acquire))
+        {
+            return false; // master已停止写线程，退回同步写入
+        }
+    }
+
+    // 槽位过半时通过futex唤醒master的写线程
+    if (shared_ring_->over_half())
+    {
+        shared_ring_->notify();
+    }
+    return true;
+}
+
+bool Logger::push_async(LogRing *ring, const std::string &frame)
+{
+    while (!ring->push(frame.data(), static_cast<uint32_t>(frame.size())))
+    {
+        // 单条日志超过缓冲区容量或策略为丢弃时，直接计数返回
+        if (async_options_.policy == DROP || frame.size() + sizeof(uint32_t) > ring->capacity())
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // 短暂休眠而不是自旋，把CPU让给后台写线程
+        wake_writer();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+        if (!async_running_.load(std::memory_order_acquire))
+        {
+            return false; // 后台线程已停止，退回同步写入
+        }
+    }
+
+    // 缓冲区过半时提前唤醒后台线程，其余情况等待定时刷盘
+    if (ring->used() > ring->capacity() / 2)
+    {
+        wake_writer();
+    }
+    return true;
+}
+
+void Logger::wake_writer()
+{
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel))
+    {
+        wake_cv_.notify_one();
+    }
+}
+
+void Logger::configure_async(const AsyncOptions &options)
+{
+    async_options_ = options;
+}
+
+void Logger::enable_shared_ring(size_t slots)
+{
+    if (shared_ring_ != nullptr)
+    {
+        return;
+    }
+
+    shared_ring_ = SharedLogRing::create(slots);
+    shared_owner_ = getpid();
+    shared_active_.store(true, std::memory_order_release);
+}
+
+void Logger::start_async()
+{
+    if (async_running_.load())
+    {
+        return;
+    }
+
+    // 共享模式下worker只负责写入共享缓冲区，由master统一写文件
+    bool shared_owner = shared_ring_ != nullptr && getpid() == shared_owner_;
+    if (shared_ring_ != nullptr && !shared_owner)
+    {
+        return;
+    }
+    if (!async_options_.enabled && !shared_owner)
+    {
         return;
+    }
+
+    stop_writer_.store(false);
+    async_running_.store(true, std::memory_order_release);
+
+    // 写线程屏蔽所有信号，保证信号由主线程处理（如master的sigsuspend）
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    writer_ = std::thread(&Logger::writer_loop, this);
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+}
+
+void Logger::notify_writer()
+{
+    wake_cv_.notify_one();
+    if (shared_ring_ != nullptr)
+    {
+        shared_ring_->notify();
+    }
+}
+
+void Logger::flush()
+{
+    if (!async_running_.load(std::memory_order_acquire))
+    {
+        return; // 同步模式下每条日志都已直接写入
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    uint64_t seq = ++flush_requested_;
+    notify_writer();
+    flush_cv_.wait(lock, [this, seq]
+                   { return flush_done_ >= seq; });
+}
+
+void Logger::shutdown()
+{
+    if (!async_running_.exchange(false))
+    {
+        return;
+    }
+
+    stop_writer_.store(true, std::memory_order_release);
+    notify_writer();
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+
+    // 处理停止过程中仍写入缓冲区的日志
+    std::string batch;
+    size_t lines;
+    while ((lines = drain_rings(batch, SIZE_MAX, kMaxBatchBytes)) > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_lines(batch, static_cast<int>(lines));
+        batch.clear();
+    }
+    if (shared_ring_ != nullptr)
+    {
+        // 之后的日志直接同步写入
+        shared_active_.store(false, std::memory_order_release);
+
+        std::string access_batch;
+        size_t records = 0;
+        while ((lines = drain_shared(batch, access_batch, SIZE_MAX, kMaxBatchBytes, records)) > 0 || records > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (lines > 0)
+                write_lines(batch, static_cast<int>(lines));
+            if (records > 0)
+                write_access(access_batch);
+            batch.clear();
+            access_batch.clear();
+        }
+    }
+    while (drain_rings(batch, SIZE_MAX, kMaxBatchBytes, true) > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_access(batch);
+        batch.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    flush_done_ = flush_requested_;
+    flush_cv_.notify_all();
+}
+
+void Logger::writer_loop()
+{
+    std::string batch;
+    batch.reserve(kMaxBatchBytes);
+    std::string access_batch;
+
+    while (true)
+    {
+        uint64_t flush_seq;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            flush_seq = flush_requested_;
+        }
+        // 先读取唤醒序号再取数据，避免漏掉两者之间的唤醒
+        uint32_t wake_seq = shared_ring_ != nullptr ? shared_ring_->wake_sequence() : 0;
+        bool stopping = stop_writer_.load(std::memory_order_acquire);
+
+        size_t total = 0;
+        while (true)
+        {
+            // 每批最多写到触发切换的行数/字节数，保证切换点准确
+            size_t max_lines = SIZE_MAX;
+            if (rotation_.max_lines > 0)
+            {
+                int remaining = rotation_.max_lines - current_lines_.load(std::memory_order_relaxed);
+                max_lines = remaining > 0 ? remaining : 1;
+            }
+            size_t max_bytes = kMaxBatchBytes;
+            if (rotation_.max_bytes > 0)
+            {
+                size_t written = current_bytes_.load(std::memory_order_relaxed);
+                max_bytes = std::min(max_bytes, written < rotation_.max_bytes ? rotation_.max_bytes - written : 1);
+            }
+            size_t lines = drain_rings(batch, max_lines, max_bytes);
+            size_t records = 0;
+            if (shared_ring_ != nullptr && lines < max_lines)
+            {
+                lines += drain_shared(batch, access_batch, max_lines - lines, max_bytes, records);
+            }
+
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (shared_ring_ != nullptr)
+            {
+                dropped += shared_ring_->dropped();
+            }
+            if (dropped != reported_dropped_)
+            {
+                format_line(batch, WARNING, "Async logger dropped " + std::to_string(dropped - reported_dropped_) + " messages");
+                reported_dropped_ = dropped;
+                lines++;
+            }
+
+            if (lines == 0 && records == 0)
+                break;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (lines > 0)
+                write_lines(batch, static_cast<int>(lines));
+            if (records > 0)
+                write_access(access_batch);
+            batch.clear();
+            access_batch.clear();
+            total += lines + records;
+        }
+
+        // 访问记录单独批量写入访问日志文件
+        size_t records;
+        while ((records = drain_rings(batch, SIZE_MAX, kMaxBatchBytes, true)) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            write_access(batch);
+            batch.clear();
+            total += records;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            flush_done_ = flush_seq;
+        }
+        flush_cv_.notify_all();
+
+        if (stopping && total == 0)
+        {
+            break;
+        }
+
+        if (total == 0 && shared_ring_ != nullptr)
+        {
+            // 共享模式下由futex唤醒（worker进程无法通知本进程的条件变量）
+            shared_ring_->wait(wake_seq, async_options_.flush_interval_ms);
+        }
+        else if (total == 0)
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(async_options_.flush_interval_ms),
+                              [this, flush_seq]
+                              { return stop_writer_.load() || flush_requested_ != flush_seq || wake_pending_.load(); });
+            wake_pending_.store(false, std::memory_order_release);
+        }
+    }
+}
+
+size_t Logger::drain_rings(std::string &batch, size_t max_lines, size_t max_bytes, bool access)
+{
+    thread_local std::vector<LogRing *> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings.clear();
+        for (auto &ring : access ? access_rings_ : rings_)
+        {
+            rings.push_back(ring.get());
+        }
+    }
+
+    size_t lines = 0;
+    for (LogRing *ring : rings)
+    {
+        while (lines < max_lines && batch.size() < max_bytes && ring->pop(batch))
+        {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+size_t Logger::drain_shared(std::string &batch, std::string &access_batch, size_t max_lines,
+                            size_t max_bytes, size_t &records)
+{
+    size_t lines = 0;
+    records = 0;
+    const char *data;
+    uint32_t len;
+    uint8_t channel;
+
+    while (lines < max_lines && batch.size() < max_bytes && access_batch.size() < kMaxBatchBytes &&
+           shared_ring_->front(data, len, channel))
+    {
+        if (channel == 0)
+        {
+            batch.append(data, len);
+            lines++;
+        }
+        else
+        {
+            access_batch.append(data, len);
+            records++;
+        }
+        shared_ring_->pop();
+    }
+    return lines;
+}
+
+LogRing *Logger::local_ring(bool access)
+{
+    LogRing *&local = access ? t_access_ring : t_ring;
+    if (local == nullptr)
+    {
+        auto ring = std::make_unique<LogRing>(async_options_.ring_bytes);
+        local = ring.get();
 
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        (access ? access_rings_ : rings_).push_back(std::move(ring));
+    }
+    return local;
+}
+
+void Logger::format_line(std::string &out, LogLevel level, const std::string &message)
+{
     // 格式化日志级别字符串
     const char *level_str = "";
     switch (level)
     {
+    case TRACE:
+        level_str = "TRACE";
+        break;
+    case DEBUG:
+        level_str = "DEBUG";
+        break;
     case INFO:
         level_str = "INFO";
         break;
@@ -63,38 +610,116 @@ void Logger::log(LogLevel level, const std::string &message)
     }
 
     // 构建日志条目
-    log_file_ << "[" << get_time_string("%Y-%m-%d %H:%M:%S") << "] "
-              << "[" << level_str << "] "
-              << message << "\n";
+    out += "[";
+    append_timestamp(out);
+    out += "] [";
+    out += level_str;
+    out += "] ";
+    out += message;
+    out += "\n";
+}
+
+void Logger::write_lines(const std::string &data, int lines)
+{
+    if (log_fd_ < 0)
+        return;
 
-    log_file_.flush();
-    if (log_file_.fail())
+    check_file(); // 跨天或到达切换间隔时先切换文件
+    write_fd(log_fd_, data.data(), data.size());
+    current_lines_ += lines;
+    current_bytes_ += data.size();
+
+    // 检查是否需要切换文件（只比较内存中的计数，不访问文件系统）
+    if ((rotation_.max_lines > 0 && current_lines_ >= rotation_.max_lines) ||
+        (rotation_.max_bytes > 0 && current_bytes_ >= rotation_.max_bytes))
     {
-        std::cerr << "Write to log file failed!" << std::endl;
-        log_file_.clear();
+        rotate_file();
     }
+}
 
-    current_lines_++;
+void Logger::write_access(const std::string &data)
+{
+    timespec now;
+    const TimeCache &time = cached_time(now);
 
-    // 检查是否需要切换文件
-    if (current_lines_ >= max_lines_)
+    // 访问日志按天分文件
+    if (access_fd_ < 0 || access_date_.compare(0, std::string::npos, time.datetime, 10) != 0)
     {
-        rotate_file();
+        access_date_.assign(time.datetime, 10);
+        open_access_file();
+    }
+
+    if (access_fd_ >= 0)
+    {
+        write_fd(access_fd_, data.data(), data.size());
+    }
+}
+
+void Logger::open_access_file()
+{
+    if (access_fd_ >= 0)
+    {
+        close(access_fd_);
+    }
+
+    std::string filename = log_dir_ + "/access_" + access_date_ + ".bin";
+
+    // 新建文件时写入文件头；文件已存在（如其他worker已创建）则直接追加
+    access_fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+    if (access_fd_ >= 0)
+    {
+        AccessLogHeader header = make_access_log_header();
+        write_fd(access_fd_, reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    else if (errno == EEXIST)
+    {
+        access_fd_ = open(filename.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+
+    if (access_fd_ < 0)
+    {
+        std::cerr << "Failed to open access log: " << filename << std::endl;
+    }
+}
+
+void Logger::write_fd(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = ::write(fd, data, len);
+        if (n > 0)
+        {
+            data += n;
+            len -= n;
+            continue;
+        }
+        if (n == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        std::cerr << "Write to log file failed!" << std::endl;
+        return;
     }
 }
 
 void Logger::check_file()
 {
-    std::string today = get_time_string("%Y-%m-%d");
+    timespec now;
+    const TimeCache &time = cached_time(now);
+    const size_t date_len = 10; // "YYYY-MM-DD"
 
     // 如果日期或文件索引变化需要切换文件
-    if (today != current_date_)
+    if (current_date_.compare(0, std::string::npos, time.datetime, date_len) != 0)
     {
-        current_date_ = today;
+        current_date_.assign(time.datetime, date_len);
         file_index_ = 0;
         rotate_file();
     }
-    else if (!log_file_.is_open())
+    else if (log_fd_ < 0)
+    {
+        rotate_file();
+    }
+    else if (rotation_.interval_seconds > 0 && now.tv_sec - file_opened_at_ >= rotation_.interval_seconds)
     {
         rotate_file();
     }
@@ -102,43 +727,161 @@ void Logger::check_file()
 
 void Logger::rotate_file()
 {
-    if (log_file_.is_open())
+    if (log_fd_ >= 0)
     {
-        log_file_.close();
+        close(log_fd_);
+        log_fd_ = -1;
+        archive_file(current_path_, current_bytes_);
     }
 
-    // 生成新文件名
-    std::string filename;
-    do
+    // 生成新文件名，索引在内存中递增，无需逐个探测文件是否存在
+    std::string filename = log_dir_ + "/" + current_date_;
+    if (file_index_ > 0)
     {
-        filename = log_dir_ + "/" + current_date_;
-        if (file_index_ > 0)
-        {
-            filename += "_" + std::to_string(file_index_);
-        }
-        filename += ".log";
-        file_index_++;
-    } while (std::filesystem::exists(filename));
+        filename += "_" + std::to_string(file_index_);
+    }
+    filename += ".log";
+    file_index_++;
 
-    log_file_.open(filename, std::ios::app);
+    // O_APPEND保证每次write整体追加到文件末尾
+    log_fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
 
     // 检查文件是否成功打开
-    if (!log_file_.is_open())
+    if (log_fd_ < 0)
     {
         throw std::runtime_error("Failed to open log file: " + filename);
     }
 
-    log_file_ << "[" << get_time_string("%Y-%m-%d %H:%M:%S") << "] [SYSTEM] Log file created\n";
-    log_file_.flush();
+    std::string header = "[";
+    append_timestamp(header);
+    header += "] [SYSTEM] Log file created\n";
+    write_fd(log_fd_, header.data(), header.size());
 
+    current_path_ = filename;
     current_lines_ = 0;
+    current_bytes_ = header.size();
+    file_opened_at_ = time(nullptr);
+}
+
+void Logger::scan_existing_files()
+{
+    struct Found
+    {
+        std::string date;
+        int index;
+        std::string path;
+        size_t bytes;
+    };
+    std::vector<Found> found;
+
+    for (const auto &entry : std::filesystem::directory_iterator(log_dir_))
+    {
+        std::string date;
+        int index;
+        if (entry.is_regular_file() && parse_log_name(entry.path().filename().string(), date, index))
+        {
+            found.push_back({date, index, entry.path().string(), static_cast<size_t>(entry.file_size())});
+        }
+    }
+
+    std::sort(found.begin(), found.end(), [](const Found &a, const Found &b)
+              { return std::tie(a.date, a.index) < std::tie(b.date, b.index); });
+
+    timespec now;
+    std::string today(cached_time(now).datetime, 10);
+
+    // 今天已有文件时从最大索引之后继续编号
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    closed_files_.clear();
+    for (const auto &file : found)
+    {
+        closed_files_.push_back({file.path, file.bytes});
+        if (file.date == today)
+        {
+            current_date_ = today;
+            file_index_ = std::max(file_index_, file.index + 1);
+        }
+    }
+    enforce_retention();
+}
+
+void Logger::archive_file(const std::string &path, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    closed_files_.push_back({path, bytes});
+
+    if (rotation_.compress)
+    {
+        // 切换频率很低，每次压缩使用一个分离线程，不受fork影响
+        pending_compress_++;
+        std::thread(&Logger::compress_file, this, path).detach();
+    }
+
+    enforce_retention();
 }
 
-std::string Logger::get_time_string(const char *format)
+void Logger::enforce_retention()
 {
-    time_t now = time(nullptr);
-    tm *local_time = localtime(&now);
-    char buffer[80];
-    strftime(buffer, sizeof(buffer), format, local_time);
-    return buffer;
+    size_t total = 0;
+    for (const auto &file : closed_files_)
+    {
+        total += file.bytes;
+    }
+
+    while (!closed_files_.empty() &&
+           ((rotation_.max_files > 0 && closed_files_.size() > rotation_.max_files) ||
+            (rotation_.max_total_bytes > 0 && total > rotation_.max_total_bytes)))
+    {
+        const ClosedFile &oldest = closed_files_.front();
+        unlink(oldest.path.c_str());
+        total -= oldest.bytes;
+        closed_files_.pop_front();
+    }
+}
+
+void Logger::compress_file(const std::string &path)
+{
+    std::string gz_path = path + ".gz";
+    bool ok = gzip_file(path, gz_path);
+
+    std::lock_guard<std::mutex> lock(files_mutex_);
+    auto it = std::find_if(closed_files_.begin(), closed_files_.end(), [&path](const ClosedFile &file)
+                           { return file.path == path; });
+
+    if (ok && it != closed_files_.end())
+    {
+        unlink(path.c_str());
+        it->path = gz_path;
+        std::error_code ec;
+        it->bytes = static_cast<size_t>(std::filesystem::file_size(gz_path, ec));
+        enforce_retention();
+    }
+    else
+    {
+        unlink(gz_path.c_str()); // 压缩失败或原文件已被保留策略删除
+    }
+
+    pending_compress_--;
+    compress_cv_.notify_all();
+}
+
+void Logger::append_timestamp(std::string &out)
+{
+    timespec now;
+    const TimeCache &time = cached_time(now);
+    out.append(time.datetime, time.len);
+
+    switch (precision_.load(std::memory_order_relaxed))
+    {
+    case MILLISECONDS:
+        out += '.';
+        append_digits(out, now.tv_nsec / 1000000, 3);
+        break;
+    case MICROSECONDS:
+        out += '.';
+        append_digits(out, now.tv_nsec / 1000, 6);
+        break;
+    default:
+        break;
+    }
 }
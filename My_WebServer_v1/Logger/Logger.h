@@ -1,42 +1,191 @@
 #pragma once
 
+#include "Log_Ring.h"
+#include "Shared_Log_Ring.h"
+#include "Access_Log.h"
 #include <string>
-#include <fstream>
 #include <ctime>
 #include <filesystem>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <condition_variable>
+
+// 编译期最低日志级别（0=TRACE ... 4=ERROR），低于该级别的日志调用在编译期被消除
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
 
 class Logger
 {
 public:
     enum LogLevel
     {
+        TRACE,
+        DEBUG,
         INFO,
         WARNING,
         ERROR
     };
 
+    static constexpr LogLevel kCompileLevel = static_cast<LogLevel>(LOG_MIN_LEVEL);
+
+    // 异步模式下线程缓冲区写满时的处理策略
+    enum OverflowPolicy
+    {
+        DROP, // 丢弃该条日志并计数
+        BLOCK // 等待后台线程腾出空间
+    };
+
+    // 时间戳精度，毫秒/微秒部分追加在秒级缓存之后
+    enum TimePrecision
+    {
+        SECONDS,
+        MILLISECONDS,
+        MICROSECONDS
+    };
+
+    struct AsyncOptions
+    {
+        bool enabled = false;
+        size_t ring_bytes = 1 << 20;   // 每个线程的环形缓冲区大小
+        OverflowPolicy policy = DROP;  // 缓冲区满时的策略
+        int flush_interval_ms = 100;   // 后台线程最长刷盘间隔
+    };
+
+    // 日志切换与保留策略，各项为0表示不启用
+    struct RotationOptions
+    {
+        int max_lines = 1000;        // 按行数切换
+        size_t max_bytes = 0;        // 按文件大小切换
+        int interval_seconds = 0;    // 按时间间隔切换
+        bool compress = false;       // 切换后在后台gzip压缩旧文件
+        size_t max_files = 0;        // 最多保留的历史文件数
+        size_t max_total_bytes = 0;  // 历史文件总大小上限
+    };
+
     static Logger &get_instance();
 
     void init(const std::string &log_dir = "logging",
               int max_lines = 1000);
+    void init(const std::string &log_dir, const RotationOptions &rotation);
     void log(LogLevel level, const std::string &message);
 
+    void set_level(LogLevel level) { level_.store(level, std::memory_order_relaxed); } // 设置运行期日志级别
+    LogLevel level() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+    void set_time_precision(TimePrecision precision) { precision_.store(precision, std::memory_order_relaxed); }
+
+    void enable_access_log(bool enabled = true) { access_enabled_.store(enabled, std::memory_order_relaxed); } // 开启二进制访问日志
+    bool access_log_enabled() const { return access_enabled_.load(std::memory_order_relaxed); }
+    void log_access(AccessRecord record, std::string_view uri); // 写入一条访问记录（URI附在记录之后）
+
+    void configure_async(const AsyncOptions &options); // 设置异步参数
+    void enable_shared_ring(size_t slots = 16384);     // 多进程共享日志：master在fork之前调用
+    void start_async();                                // 启动后台写线程（fork之后在各进程内调用）
+    void flush();                                      // 等待已提交的日志全部写入文件
+    void shutdown();                                   // 停止后台写线程并刷盘
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
 private:
     Logger() = default;
     ~Logger();
 
-    void check_file();//检查文件
+    void check_file();//检查文件，日期变化或到达切换间隔时切换到新文件
 
     void rotate_file();
-    std::string get_time_string(const char *format);    //获取时间字符串
+    void scan_existing_files();       //启动时扫描日志目录，恢复文件索引与历史文件列表
+    void archive_file(const std::string &path, size_t bytes); //登记已关闭的文件并执行保留策略
+    void enforce_retention();         //删除超出保留上限的旧文件（需持有files_mutex_）
+    void compress_file(const std::string &path); //后台线程：gzip压缩旧文件
+    void append_timestamp(std::string &out); //追加缓存的时间戳
+
+    void format_line(std::string &out, LogLevel level, const std::string &message); // 格式化日志行
+    void write_lines(const std::string &data, int lines);                           // 写入文件并按行数切换（需持有mutex_）
+    void write_access(const std::string &data);                                     // 写入访问日志文件（需持有mutex_）
+    void open_access_file();                                                        // 打开当天的访问日志文件
+    void write_fd(int fd, const char *data, size_t len);                            // 完整写入fd
+    bool push_async(LogRing *ring, const std::string &frame);                       // 写入缓冲区，返回false表示需退回同步写入
+    bool push_shared(const std::string &frame, uint8_t channel);                    // 写入跨进程共享缓冲区
+    size_t drain_shared(std::string &batch, std::string &access_batch, size_t max_lines,
+                        size_t max_bytes, size_t &records);                         // 取出共享缓冲区中的日志，返回行数
+    void notify_writer();                                                           // 唤醒后台写线程（含共享模式）
+    void wake_writer();                                                             // 唤醒后台写线程
+    LogRing *local_ring(bool access = false);                                       // 当前线程的环形缓冲区
+    void writer_loop();                                                             // 后台写线程主循环
+    size_t drain_rings(std::string &batch, size_t max_lines, size_t max_bytes,
+                       bool access = false);                                        // 取出缓冲区中的日志，返回条数
 
-    std::ofstream log_file_;    //日志文件
+    std::atomic<int> level_{INFO}; //运行期日志级别
+    std::atomic<int> precision_{SECONDS}; //时间戳精度
+    int log_fd_ = -1;    //日志文件
     std::string log_dir_;   //日志目录
-    int max_lines_; //最大行数
+    RotationOptions rotation_; //切换策略
     std::atomic<int> current_lines_{0}; //当前行数
+    std::atomic<size_t> current_bytes_{0}; //当前文件字节数
+    time_t file_opened_at_ = 0; //当前文件的创建时间
+    std::string current_path_;  //当前文件路径
     std::string current_date_;  //当前日期
-    int file_index_{0}; //文件索引
+    int file_index_{0}; //下一个文件索引，只在内存中递增
     std::mutex mutex_;
+
+    // 历史文件（从旧到新），用于保留策略，避免运行期扫描目录
+    struct ClosedFile
+    {
+        std::string path;
+        size_t bytes;
+    };
+    std::mutex files_mutex_;
+    std::deque<ClosedFile> closed_files_;
+    int pending_compress_ = 0; //正在压缩的文件数
+    std::condition_variable compress_cv_;
+
+    // 异步后端
+    AsyncOptions async_options_;
+    std::atomic<bool> async_running_{false};
+    std::atomic<bool> stop_writer_{false};
+    std::atomic<bool> wake_pending_{false}; // 生产者已请求唤醒
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t reported_dropped_ = 0;
+    std::thread writer_;
+
+    std::mutex rings_mutex_;                     // 保护rings_的注册
+    std::vector<std::unique_ptr<LogRing>> rings_; // 所有线程的缓冲区（线程退出后仍保留）
+    std::vector<std::unique_ptr<LogRing>> access_rings_; // 访问日志缓冲区
+
+    // 多进程共享缓冲区：所有进程写入，只有创建它的master进程负责写文件
+    SharedLogRing *shared_ring_ = nullptr;
+    pid_t shared_owner_ = 0;
+    std::atomic<bool> shared_active_{false};
+
+    // 二进制访问日志
+    std::atomic<bool> access_enabled_{false};
+    int access_fd_ = -1;
+    std::string access_date_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;  // 唤醒后台写线程
+    std::condition_variable flush_cv_; // 通知flush()完成
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_done_ = 0;
 };
+
+// 日志前端宏：级别未开启时只有一次比较，消息表达式不会被求值
+#define LOG_AT(level, message)                                                              \
+    do                                                                                      \
+    {                                                                                       \
+        if ((level) >= Logger::kCompileLevel && Logger::get_instance().enabled(level))      \
+        {                                                                                   \
+            Logger::get_instance().log(level, message);                                     \
+        }                                                                                   \
+    } while (0)
+
+#define LOG_TRACE(message) LOG_AT(Logger::TRACE, message)
+#define LOG_DEBUG(message) LOG_AT(Logger::DEBUG, message)
+#define LOG_INFO(message) LOG_AT(Logger::INFO, message)
+#define LOG_WARNING(message) LOG_AT(Logger::WARNING, message)
+#define LOG_ERROR(message) LOG_AT(Logger::ERROR, message)
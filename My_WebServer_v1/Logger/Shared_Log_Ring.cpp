@@ -0,0 +1,197 @@
+#include "Shared_Log_Ring.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <system_error>
+
+namespace
+{
+    constexpr int64_t kStallTimeoutMs = 1000; // 槽位未就绪超过该时间才检查写入进程是否存活
+
+    int64_t now_ms()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+}
+
+SharedLogRing *SharedLogRing::create(size_t slots)
+{
+    size_t capacity = 2;
+    while (capacity < slots)
+    {
+        capacity <<= 1;
+    }
+
+    size_t size = slots_offset() + capacity * sizeof(Slot);
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        throw std::system_error(errno, std::generic_category(), "mmap shared log ring");
+    }
+
+    return new (memory) SharedLogRing(capacity, size);
+}
+
+void SharedLogRing::destroy(SharedLogRing *ring)
+{
+    if (ring != nullptr)
+    {
+        size_t size = ring->control_.mapping_size;
+        ring->~SharedLogRing();
+        munmap(ring, size);
+    }
+}
+
+SharedLogRing::SharedLogRing(size_t slots, size_t mapping_size)
+{
+    control_.enqueue_pos.store(0);
+    control_.dequeue_pos.store(0);
+    control_.dropped.store(0);
+    control_.wake_seq.store(0);
+    control_.capacity = slots;
+    control_.mapping_size = mapping_size;
+
+    for (uint64_t i = 0; i < slots; ++i)
+    {
+        Slot *s = new (&slot(i)) Slot;
+        s->sequence.store(i, std::memory_order_relaxed);
+        s->owner.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t SharedLogRing::slots_offset()
+{
+    return (sizeof(SharedLogRing) + 63) & ~size_t(63);
+}
+
+SharedLogRing::Slot &SharedLogRing::slot(uint64_t pos)
+{
+    char *base = reinterpret_cast<char *>(this) + slots_offset();
+    return reinterpret_cast<Slot *>(base)[pos & (control_.capacity - 1)];
+}
+
+bool SharedLogRing::push(const char *data, size_t len, uint8_t channel)
+{
+    uint64_t pos = control_.enqueue_pos.load(std::memory_order_relaxed);
+    Slot *target;
+
+    while (true)
+    {
+        target = &slot(pos);
+        uint64_t seq = target->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+        if (diff == 0)
+        {
+            // 槽位空闲，尝试占用
+            if (control_.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false; // 队列已满
+        }
+        else
+        {
+            pos = control_.enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    target->owner.store(getpid(), std::memory_order_relaxed);
+    target->length = static_cast<uint32_t>(len < kPayloadSize ? len : kPayloadSize);
+    target->channel = channel;
+    std::memcpy(target->data, data, target->length);
+    target->sequence.store(pos + 1, std::memory_order_release); // 发布
+    return true;
+}
+
+bool SharedLogRing::front(const char *&data, uint32_t &len, uint8_t &channel)
+{
+    while (true)
+    {
+        uint64_t pos = control_.dequeue_pos.load(std::memory_order_relaxed);
+        Slot &current = slot(pos);
+        uint64_t seq = current.sequence.load(std::memory_order_acquire);
+
+        if (seq == pos + 1)
+        {
+            stalled_pos_ = UINT64_MAX;
+            data = current.data;
+            len = current.length;
+            channel = current.channel;
+            return true;
+        }
+
+        // 槽位已被占用但尚未发布：可能正在写入，也可能写入进程已崩溃
+        if (control_.enqueue_pos.load(std::memory_order_relaxed) == pos || !skip_stalled_slot(current))
+        {
+            return false;
+        }
+    }
+}
+
+void SharedLogRing::pop()
+{
+    uint64_t pos = control_.dequeue_pos.load(std::memory_order_relaxed);
+    Slot &current = slot(pos);
+    current.owner.store(0, std::memory_order_relaxed);
+    current.sequence.store(pos + control_.capacity, std::memory_order_release); // 归还槽位
+    control_.dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+}
+
+bool SharedLogRing::skip_stalled_slot(Slot &current)
+{
+    uint64_t pos = control_.dequeue_pos.load(std::memory_order_relaxed);
+    if (stalled_pos_ != pos)
+    {
+        stalled_pos_ = pos;
+        stalled_since_ms_ = now_ms();
+        return false;
+    }
+
+    if (now_ms() - stalled_since_ms_ < kStallTimeoutMs)
+    {
+        return false;
+    }
+
+    pid_t owner = current.owner.load(std::memory_order_relaxed);
+    if (owner > 0 && (kill(owner, 0) == 0 || errno != ESRCH))
+    {
+        return false; // 写入进程仍存活，继续等待
+    }
+
+    // 写入进程已退出，放弃该槽位
+    add_dropped();
+    pop();
+    stalled_pos_ = UINT64_MAX;
+    return true;
+}
+
+bool SharedLogRing::over_half() const
+{
+    uint64_t used = control_.enqueue_pos.load(std::memory_order_relaxed) -
+                    control_.dequeue_pos.load(std::memory_order_relaxed);
+    return used > control_.capacity / 2;
+}
+
+void SharedLogRing::notify()
+{
+    control_.wake_seq.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, &control_.wake_seq, FUTEX_WAKE, 1, nullptr, nullptr, 0); // 共享映射上的futex可跨进程唤醒
+}
+
+void SharedLogRing::wait(uint32_t seen_sequence, int timeout_ms)
+{
+    timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, &control_.wake_seq, FUTEX_WAIT, seen_sequence, &timeout, nullptr, 0);
+}
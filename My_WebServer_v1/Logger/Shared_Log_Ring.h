@@ -0,0 +1,68 @@
+#ifndef SHARED_LOG_RING_H
+#define SHARED_LOG_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+// 跨进程共享的日志环形缓冲区（mmap匿名共享内存，在fork之前创建）
+// 多生产者（各worker及master）定长槽位无锁入队，单消费者（master的写线程）出队
+class SharedLogRing
+{
+public:
+    static constexpr size_t kSlotSize = 512;
+    static constexpr size_t kPayloadSize = kSlotSize - 24; // 单条记录的最大字节数，超出部分截断
+
+    static SharedLogRing *create(size_t slots); // 槽位数向上取整为2的幂
+    static void destroy(SharedLogRing *ring);
+
+    bool push(const char *data, size_t len, uint8_t channel); // 生产者：写入一条记录，已满返回false
+
+    // 消费者：查看队首记录，未就绪返回false；处理完后调用pop()
+    bool front(const char *&data, uint32_t &len, uint8_t &channel);
+    void pop();
+
+    uint64_t dropped() const { return control_.dropped.load(std::memory_order_relaxed); }
+    void add_dropped() { control_.dropped.fetch_add(1, std::memory_order_relaxed); }
+    bool over_half() const; // 已用槽位是否过半
+
+    uint32_t wake_sequence() const { return control_.wake_seq.load(std::memory_order_acquire); }
+    void notify();                                 // 唤醒消费者（可跨进程）
+    void wait(uint32_t seen_sequence, int timeout_ms); // 消费者：等待唤醒或超时
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence; // Vyukov队列的槽位序号
+        std::atomic<int32_t> owner;     // 正在写入该槽位的进程
+        uint32_t length;
+        uint8_t channel;
+        char padding[3];
+        char data[kPayloadSize];
+    };
+    static_assert(sizeof(Slot) == kSlotSize, "unexpected slot layout");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+    struct Control
+    {
+        alignas(64) std::atomic<uint64_t> enqueue_pos;
+        alignas(64) std::atomic<uint64_t> dequeue_pos;
+        alignas(64) std::atomic<uint64_t> dropped;
+        std::atomic<uint32_t> wake_seq; // futex字
+        uint64_t capacity;
+        size_t mapping_size;
+    };
+
+    SharedLogRing(size_t slots, size_t mapping_size);
+    Slot &slot(uint64_t pos); // 槽位数组紧随对象之后
+    bool skip_stalled_slot(Slot &slot); // 写入进程已退出时跳过卡住的槽位
+
+    static size_t slots_offset();
+
+    Control control_;
+    uint64_t stalled_pos_ = UINT64_MAX; // 仅消费者使用：首次发现未就绪的位置
+    int64_t stalled_since_ms_ = 0;
+};
+
+#endif
@@ -10,30 +10,24 @@
 
 bool ProcessMaster::master_keep_running = true;
 
-// 全局变量，用于存储 reactor 指针
-static EpollReactor *g_reactor = nullptr;
-
-// Worker进程信号处理函数
-void worker_signal_handler(int sig)
+// SIGUSR1/SIGUSR2 调低/调高当前worker的日志级别，便于单独排查某个worker
+static void adjust_log_level(int sig)
 {
-    std::cout << "Worker " << getpid() << " received signal " << sig << "\n";
-
-    if (g_reactor)
+    Logger &logger = Logger::get_instance();
+    int level = logger.level();
+    if (sig == SIGUSR1 && level > Logger::TRACE)
     {
-        g_reactor->stop();
+        logger.set_level(static_cast<Logger::LogLevel>(level - 1));
+    }
+    else if (sig == SIGUSR2 && level < Logger::ERROR)
+    {
+        logger.set_level(static_cast<Logger::LogLevel>(level + 1));
     }
 }
 
 // Worker进程执行逻辑
-void worker_process(int worker_id, int listen_fd)
+void worker_process(int worker_id, int listen_fd, Logger::LogLevel log_level)
 {
-    // 捕获SIGTERM信号
-    struct sigaction sa;
-    sa.sa_handler = worker_signal_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGTERM, &sa, nullptr);
-
     // 忽略SIGINT信号
     struct sigaction sa_ignore;
     sa_ignore.sa_handler = SIG_IGN;
@@ -41,29 +35,38 @@ void worker_process(int worker_id, int listen_fd)
     sa_ignore.sa_flags = 0;
     sigaction(SIGINT, &sa_ignore, nullptr);
 
+    Logger::get_instance().set_level(log_level);
+
+    // 后台写线程不会随fork复制，需在worker进程内启动
+    Logger::get_instance().start_async();
+
     // 工作循环
     EpollReactor reactor;
-    g_reactor = &reactor;
+
+    // 信号经自管道转入事件循环处理：SIGTERM退出，SIGUSR1/SIGUSR2调整日志级别
+    reactor.handle_signal(SIGTERM, [&reactor]
+                          {
+        LOG_INFO("Worker " + std::to_string(getpid()) + " received SIGTERM");
+        reactor.stop(); });
+    reactor.handle_signal(SIGUSR1, []
+                          { adjust_log_level(SIGUSR1); });
+    reactor.handle_signal(SIGUSR2, []
+                          { adjust_log_level(SIGUSR2); });
+
+    ConnectionPool pool(reactor, "./root"); // 连接对象在池中复用
     TcpAcceptor acceptor(reactor, listen_fd);
 
-    acceptor.set_new_connection_callback([&reactor](int fd)
-                                         {
-            auto conn = TcpConnection::create(fd, reactor);
-            auto http_conn = std::make_shared<HTTPConnection>(*conn, "./root");
-            
-            conn->set_read_callback([http_conn](std::string& buf) {
-                http_conn->handle_input(buf);
-            });
-            
-            conn->start(); });
+    acceptor.set_new_connection_callback([&pool](int fd)
+                                         { pool.open(fd); });
 
-    Logger::get_instance().log(Logger::INFO, "Worker " + std::to_string(getpid()) +
-                                                 " started with listen_fd=" + std::to_string(listen_fd));
+    LOG_INFO("Worker " + std::to_string(getpid()) +
+             " started with listen_fd=" + std::to_string(listen_fd));
 
     reactor.run(); // 进入事件循环
 
     std::cout << "Worker " << worker_id << " exiting\n";
-    g_reactor = nullptr;
+
+    Logger::get_instance().shutdown(); // 退出前刷盘
 
     exit(0); // 正常退出
 }
@@ -78,9 +81,18 @@ ProcessMaster::ProcessMaster(int workers) : worker_count(workers)
     sigaction(SIGTERM, &sa, nullptr);
 }
 
+void ProcessMaster::set_worker_log_level(Logger::LogLevel level)
+{
+    worker_log_level = level;
+}
+
 void ProcessMaster::run(int listen_fd)
 {
     create_workers(listen_fd);
+
+    // 写线程在fork之后启动；共享日志模式下master负责汇总所有worker的日志
+    Logger::get_instance().start_async();
+
     monitor_workers();
 }
 
@@ -92,8 +104,8 @@ void ProcessMaster::create_workers(int listen_fd)
         pid_t pid = fork();
         if (pid == 0)
         {
-            Logger::get_instance().log(Logger::INFO, "Worker " + std::to_string(i) + " started");
-            worker_process(i, listen_fd);
+            LOG_INFO("Worker " + std::to_string(i) + " started");
+            worker_process(i, listen_fd, worker_log_level);
             exit(EXIT_SUCCESS);
         }
         else if (pid > 0)
@@ -133,6 +145,8 @@ void ProcessMaster::monitor_workers()
         std::cout << "Worker " << pid << " exited\n";
     }
 
+    Logger::get_instance().shutdown(); // 刷出master剩余日志
+
     std::cout << "Master process exit\n";
 }
 
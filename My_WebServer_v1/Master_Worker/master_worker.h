@@ -2,6 +2,7 @@
 #define MASTER_WORKER_H
 
 #include "../HTTP_Connection/HTTP_Connection.h"
+#include "../HTTP_Connection/Connection_Pool.h"
 #include "../Logger/Logger.h"
 #include <vector>
 #include <atomic>
@@ -13,6 +14,7 @@ class ProcessMaster {
 public:
     explicit ProcessMaster(int workers);
     void run(int listen_fd);
+    void set_worker_log_level(Logger::LogLevel level); // worker进程的初始日志级别
 
 private:
     void create_workers(int listen_fd);
@@ -21,6 +23,7 @@ private:
 
     const int worker_count;
     std::vector<pid_t> workers;
+    Logger::LogLevel worker_log_level = Logger::INFO;
     static bool master_keep_running;
 };
 
@@ -0,0 +1,259 @@
+#include "Multi_Reactor.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <csignal>
+#include <pthread.h>
+#include <sched.h>
+
+FdQueue::FdQueue(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    slots_.resize(size);
+    mask_ = size - 1;
+}
+
+bool FdQueue::push(int fd)
+{
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == slots_.size())
+    {
+        return false;
+    }
+    slots_[head & mask_] = fd;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool FdQueue::pop(int &fd)
+{
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    fd = slots_[tail & mask_];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+ReactorThread::ReactorThread(int id, std::string root_dir, int cpu)
+    : id_(id), root_dir_(std::move(root_dir)), cpu_(cpu), pending_(4096)
+{
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+}
+
+ReactorThread::~ReactorThread()
+{
+    if (thread_.joinable())
+    {
+        stop();
+        join();
+    }
+
+    // 关闭尚未被接管的连接
+    int fd;
+    while (pending_.pop(fd))
+    {
+        close(fd);
+    }
+    close(wake_fd_);
+}
+
+void ReactorThread::start()
+{
+    thread_ = std::thread(&ReactorThread::thread_main, this);
+}
+
+void ReactorThread::stop()
+{
+    stopping_.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+}
+
+void ReactorThread::join()
+{
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+bool ReactorThread::hand_off(int fd)
+{
+    if (!pending_.push(fd))
+    {
+        return false;
+    }
+
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;
+    return true;
+}
+
+size_t ReactorThread::load() const
+{
+    const ConnectionPool *pool = pool_view_.load(std::memory_order_acquire);
+    return (pool != nullptr ? pool->in_use() : 0) + pending_.size();
+}
+
+void ReactorThread::thread_main()
+{
+    if (cpu_ >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu_, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0)
+        {
+            LOG_WARNING("Failed to pin reactor thread " + std::to_string(id_) + " to CPU " +
+                        std::to_string(cpu_) + ": " + std::to_string(err));
+        }
+    }
+
+    reactor_ = std::make_unique<EpollReactor>();
+    pool_ = std::make_unique<ConnectionPool>(*reactor_, root_dir_);
+    pool_view_.store(pool_.get(), std::memory_order_release);
+
+    // eventfd计数在注册前就可能非零，注册后会立即触发一次
+    reactor_->add_fd(wake_fd_, EPOLLIN, [this](uint32_t events)
+                     {
+        uint64_t count;
+        ssize_t n = read(wake_fd_, &count, sizeof(count));
+        (void)n;
+        drain_pending();
+        if (stopping_.load(std::memory_order_acquire))
+        {
+            reactor_->stop();
+        } });
+
+    LOG_INFO("Reactor thread " + std::to_string(id_) + " started" +
+             (cpu_ >= 0 ? " on CPU " + std::to_string(cpu_) : std::string()));
+
+    reactor_->run();
+
+    reactor_->remove_fd(wake_fd_);
+    pool_view_.store(nullptr, std::memory_order_release);
+    pool_.reset(); // 关闭仍打开的连接
+    reactor_.reset();
+
+    LOG_INFO("Reactor thread " + std::to_string(id_) + " exiting");
+}
+
+void ReactorThread::drain_pending()
+{
+    int fd;
+    while (pending_.pop(fd))
+    {
+        pool_->open(fd);
+    }
+}
+
+MultiReactor::MultiReactor(const Options &options) : options_(options)
+{
+    if (options_.threads <= 0)
+    {
+        options_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void MultiReactor::run(int listen_fd)
+{
+    int cpus = std::max(1u, std::thread::hardware_concurrency());
+
+    // 子线程屏蔽所有信号，SIGINT/SIGTERM只会打断主线程
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    for (int i = 0; i < options_.threads; ++i)
+    {
+        workers_.push_back(std::make_unique<ReactorThread>(i, options_.root_dir, options_.pin_cpus ? i % cpus : -1));
+        workers_.back()->start();
+    }
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    main_reactor_.handle_signal(SIGINT, [this]
+                                { stop(); });
+    main_reactor_.handle_signal(SIGTERM, [this]
+                                { stop(); });
+
+    TcpAcceptor acceptor(main_reactor_, listen_fd);
+    acceptor.set_new_connection_callback([this](int fd)
+                                         { dispatch(fd); });
+
+    LOG_INFO("Main reactor started with " + std::to_string(options_.threads) + " sub-reactors");
+
+    main_reactor_.run();
+
+    for (auto &worker : workers_)
+    {
+        worker->stop();
+    }
+    for (auto &worker : workers_)
+    {
+        worker->join();
+    }
+    workers_.clear();
+
+    LOG_INFO("Main reactor exiting");
+}
+
+void MultiReactor::stop()
+{
+    main_reactor_.stop();
+}
+
+ReactorThread &MultiReactor::pick()
+{
+    size_t start = next_++ % workers_.size();
+    if (options_.balance == ROUND_ROBIN)
+    {
+        return *workers_[start];
+    }
+
+    // 从轮询位置开始找连接数最少的，负载相同时依次分散
+    size_t best = start;
+    size_t best_load = workers_[start]->load();
+    for (size_t i = 1; i < workers_.size() && best_load > 0; ++i)
+    {
+        size_t index = (start + i) % workers_.size();
+        size_t load = workers_[index]->load();
+        if (load < best_load)
+        {
+            best = index;
+            best_load = load;
+        }
+    }
+    return *workers_[best];
+}
+
+void MultiReactor::dispatch(int fd)
+{
+    if (pick().hand_off(fd))
+    {
+        return;
+    }
+
+    // 目标子reactor的队列已满，尝试其余子reactor
+    for (auto &worker : workers_)
+    {
+        if (worker->hand_off(fd))
+        {
+            return;
+        }
+    }
+
+    LOG_WARNING("All reactor queues full, dropping connection fd=" + std::to_string(fd));
+    close(fd);
+}
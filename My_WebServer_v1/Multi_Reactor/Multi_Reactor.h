@@ -0,0 +1,102 @@
+#ifndef MULTI_REACTOR_H
+#define MULTI_REACTOR_H
+
+#include "../HTTP_Connection/Connection_Pool.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 单生产者单消费者的无锁fd队列：主reactor线程写入新连接，子reactor线程取出
+class FdQueue
+{
+public:
+    explicit FdQueue(size_t capacity); // 容量向上取整为2的幂
+
+    bool push(int fd); // 生产者：队列已满返回false
+    bool pop(int &fd); // 消费者：队列为空返回false
+
+    size_t size() const
+    {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<int> slots_;
+    size_t mask_;
+
+    alignas(64) std::atomic<size_t> head_{0}; // 生产者写入位置
+    alignas(64) std::atomic<size_t> tail_{0}; // 消费者读取位置
+};
+
+// 子reactor：独立线程运行一个EpollReactor及其连接池，通过eventfd接收主reactor分配的连接
+class ReactorThread
+{
+public:
+    ReactorThread(int id, std::string root_dir, int cpu); // cpu < 0 表示不绑定CPU
+    ~ReactorThread();
+
+    ReactorThread(const ReactorThread &) = delete;
+    ReactorThread &operator=(const ReactorThread &) = delete;
+
+    void start();
+    void stop(); // 可在任意线程调用
+    void join();
+
+    bool hand_off(int fd); // 主reactor线程调用：投递新连接，队列已满返回false
+    size_t load() const;   // 当前连接数 + 待接管连接数
+
+private:
+    void thread_main();
+    void drain_pending(); // 接管队列中的全部新连接
+
+    const int id_;
+    const std::string root_dir_;
+    const int cpu_;
+
+    int wake_fd_ = -1; // eventfd，新连接入队或停止时唤醒子reactor
+    FdQueue pending_;
+    std::atomic<bool> stopping_{false};
+
+    std::unique_ptr<EpollReactor> reactor_; // 以下对象在子线程内创建和使用
+    std::unique_ptr<ConnectionPool> pool_;
+    std::atomic<const ConnectionPool *> pool_view_{nullptr}; // 供主线程读取连接数
+
+    std::thread thread_;
+};
+
+// 主reactor + N个子reactor：主线程只负责accept，连接分配给子reactor线程处理
+class MultiReactor
+{
+public:
+    enum Balance
+    {
+        ROUND_ROBIN,  // 轮询
+        LEAST_LOADED  // 分配给当前连接数最少的子reactor
+    };
+
+    struct Options
+    {
+        int threads = 0;            // 子reactor线程数，0表示使用CPU核数
+        bool pin_cpus = false;      // 是否将每个子reactor线程绑定到一个CPU
+        Balance balance = ROUND_ROBIN;
+        std::string root_dir = "./root";
+    };
+
+    explicit MultiReactor(const Options &options);
+
+    void run(int listen_fd); // 在当前线程运行主reactor，直到SIGINT/SIGTERM或stop()
+    void stop();             // 可在任意线程调用
+
+private:
+    void dispatch(int fd); // 将新连接分配给一个子reactor
+    ReactorThread &pick();
+
+    Options options_;
+    std::vector<std::unique_ptr<ReactorThread>> workers_;
+    size_t next_ = 0;
+    EpollReactor main_reactor_;
+};
+
+#endif
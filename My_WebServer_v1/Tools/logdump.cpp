@@ -0,0 +1,143 @@
+// logdump：将二进制访问日志转换为文本或JSON
+// 用法：logdump [-j] access_YYYY-MM-DD.bin...
+#include "../Logger/Access_Log.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// JSON字符串转义
+static std::string json_escape(const std::string &input)
+{
+    std::string out;
+    for (unsigned char c : input)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            }
+            else
+            {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    return out;
+}
+
+static void print_record(const AccessRecord &record, const std::string &uri, bool json)
+{
+    time_t seconds = static_cast<time_t>(record.timestamp_ns / 1000000000ULL);
+    unsigned long micros = static_cast<unsigned long>(record.timestamp_ns % 1000000000ULL / 1000);
+    tm local_time;
+    localtime_r(&seconds, &local_time);
+    char datetime[32];
+    strftime(datetime, sizeof(datetime), "%Y-%m-%d %H:%M:%S", &local_time);
+
+    if (json)
+    {
+        printf("{\"time\":\"%s.%06lu\",\"timestamp_ns\":%llu,\"pid\":%u,\"fd\":%d,\"method\":\"%s\","
+               "\"uri\":\"%s\",\"status\":%u,\"bytes\":%llu,\"latency_ns\":%llu}\n",
+               datetime, micros, static_cast<unsigned long long>(record.timestamp_ns), record.pid, record.fd,
+               access_method_name(record.method), json_escape(uri).c_str(), record.status,
+               static_cast<unsigned long long>(record.bytes_sent), static_cast<unsigned long long>(record.latency_ns));
+    }
+    else
+    {
+        printf("[%s.%06lu] pid=%u fd=%d %s %s %u %lluB %.3fus\n",
+               datetime, micros, record.pid, record.fd, access_method_name(record.method), uri.c_str(),
+               record.status, static_cast<unsigned long long>(record.bytes_sent), record.latency_ns / 1000.0);
+    }
+}
+
+static bool dump_file(const char *path, bool json)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        perror(path);
+        return false;
+    }
+
+    AccessLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, kAccessLogMagic, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "%s: not an access log\n", path);
+        fclose(file);
+        return false;
+    }
+    if (header.version != kAccessLogVersion || header.record_size < sizeof(AccessRecord))
+    {
+        fprintf(stderr, "%s: unsupported version %u\n", path, header.version);
+        fclose(file);
+        return false;
+    }
+
+    // 按文件头中的记录大小读取，兼容追加了字段的新版本
+    std::vector<char> raw(header.record_size);
+    std::string uri;
+    bool ok = true;
+    while (fread(raw.data(), raw.size(), 1, file) == 1)
+    {
+        AccessRecord record;
+        std::memcpy(&record, raw.data(), sizeof(record));
+
+        size_t skip = record.uri_offset > header.record_size ? record.uri_offset - header.record_size : 0;
+        uri.resize(record.uri_length);
+        if (fseek(file, static_cast<long>(skip), SEEK_CUR) != 0 ||
+            (record.uri_length > 0 && fread(&uri[0], record.uri_length, 1, file) != 1))
+        {
+            fprintf(stderr, "%s: truncated record\n", path);
+            ok = false;
+            break;
+        }
+        print_record(record, uri, json);
+    }
+
+    fclose(file);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    bool json = false;
+    std::vector<const char *> files;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-j") == 0 || std::strcmp(argv[i], "--json") == 0)
+        {
+            json = true;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty())
+    {
+        fprintf(stderr, "usage: %s [-j|--json] access_log.bin...\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    for (const char *path : files)
+    {
+        ok = dump_file(path, json) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include "Master_Worker/master_worker.h"
+#include "Multi_Reactor/Multi_Reactor.h"
 #include <iostream>
 
 // 创建监听套接字，用于worker进程接收客户端连接
@@ -34,21 +35,73 @@ int create_socket(int port)
     return listen_fd;
 }
 
-int main()
+// 用法：./server                 多进程模式（1个master + 3个worker进程）
+//       ./server --threads N [--pin] [--least-loaded]
+//                                 多线程模式（主reactor + N个子reactor线程，N=0表示CPU核数）
+int main(int argc, char *argv[])
 {
+    bool thread_mode = false;
+    MultiReactor::Options reactor_options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            thread_mode = true;
+            reactor_options.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--pin")
+        {
+            reactor_options.pin_cpus = true;
+        }
+        else if (arg == "--least-loaded")
+        {
+            reactor_options.balance = MultiReactor::LEAST_LOADED;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--threads N [--pin] [--least-loaded]]" << std::endl;
+            return 2;
+        }
+    }
+
     int listen_fd = create_socket(8080);
 
     try
     {
-        Logger::get_instance().init("logging", 1000);   // 初始化日志系统
+        Logger::RotationOptions rotation;
+        rotation.max_lines = 0;             // 按大小而非行数切换
+        rotation.max_bytes = 64 << 20;      // 单个文件64MB
+        rotation.compress = true;           // 旧文件后台gzip压缩
+        rotation.max_files = 50;            // 最多保留50个历史文件
+        Logger::get_instance().init("logging", rotation);   // 初始化日志系统
+        Logger::get_instance().enable_access_log();         // 访问日志以二进制格式单独记录
+
+        Logger::AsyncOptions log_options;
+        log_options.enabled = true; // 使用异步日志
+        Logger::get_instance().configure_async(log_options);
+
+        if (thread_mode)
+        {
+            Logger::get_instance().start_async();
+
+            MultiReactor server(reactor_options);
+            LOG_INFO("Server: " + std::to_string(getpid()) + " started in multi-reactor mode");
+            server.run(listen_fd);
+
+            Logger::get_instance().shutdown();
+            return 0;
+        }
+
+        Logger::get_instance().enable_shared_ring(16384);   // 各worker写入共享内存，由master统一落盘
 
         ProcessMaster master(3); // 初始化Master进程，准备创建3个Worker进程
-        Logger::get_instance().log(Logger::INFO, "Master: " + std::to_string(getpid()) + " started");
+        LOG_INFO("Master: " + std::to_string(getpid()) + " started");
         master.run(listen_fd);   // 启动Master进程
     }
     catch (const std::exception &e)
     {
-        Logger::get_instance().log(Logger::ERROR, e.what());
+        LOG_ERROR(e.what());
         // std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }